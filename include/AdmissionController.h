@@ -0,0 +1,118 @@
+#ifndef ADMISSIONCONTROLLER_H
+#define ADMISSIONCONTROLLER_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QList>
+
+/**
+ * @brief 预测式模块准入控制
+ *
+ * - 学习每种模块类型创建后带来的常驻内存和CPU增量（指数加权平均）
+ * - 准入时用 "当前值 + 预计增量" 与阈值比较，而不是只看当前值
+ * - 压力状态带迟滞：进入和退出使用不同的阈值，每次压力过程只报告一次
+ *
+ * 只在GUI线程中使用，不做任何I/O；增量来自PerformanceMonitor的采样快照。
+ */
+class AdmissionController {
+public:
+    enum Resource {
+        Cpu,
+        SystemMemory,
+        ProcessMemory,
+        RESOURCE_COUNT
+    };
+
+    enum Level {
+        Normal,
+        Warning,
+        Critical
+    };
+
+    // 某一时刻的资源使用情况
+    struct Usage {
+        double cpuPercent;
+        double memoryPercent;
+        double memoryTotalMB;
+        double processMemoryMB;
+    };
+
+    // 准入阈值
+    struct Limits {
+        double cpuPercent;
+        double memoryPercent;
+        double processMemoryMB;
+    };
+
+    // 单个模块的预计开销
+    struct Cost {
+        double cpuPercent;
+        double rssMB;
+        int samples;     // 学习到的样本数，0表示尚无数据
+    };
+
+    struct Prediction {
+        bool allowed;
+        Resource resource;   // 不允许时，触发限制的资源
+        double current;
+        double predicted;
+        double limit;
+    };
+
+    struct Transition {
+        Resource resource;
+        Level from;
+        Level to;
+        double value;
+        double limit;
+    };
+
+    // 迟滞阈值（相对阈值的比例）
+    static constexpr double WARNING_ENTER = 0.90;
+    static constexpr double WARNING_EXIT = 0.80;
+    static constexpr double CRITICAL_ENTER = 1.00;
+    static constexpr double CRITICAL_EXIT = 0.95;
+
+    // 创建后等待两次采样再结算增量
+    static const qint64 SETTLE_MS = 4000;
+
+    AdmissionController();
+
+    // 学习：记录一次创建及创建前的资源使用
+    void recordCreation(int moduleType, const Usage& before, qint64 timestampMs);
+    // 新样本到来时调用，结算已经稳定的创建记录
+    void observe(const Usage& now, qint64 timestampMs);
+
+    // 预计开销：优先使用该类型的数据，其次是所有类型的平均
+    Cost costOf(int moduleType) const;
+    int pendingCreations() const { return m_pending.size(); }
+
+    // 预测再创建count个该类型模块后是否会超过阈值
+    Prediction predict(int moduleType, const Usage& now, const Limits& limits, int count = 1) const;
+
+    // 迟滞：更新各资源的压力等级，返回发生的变化数量（写入out，最多capacity个）
+    int updatePressure(const Usage& now, const Limits& limits, Transition* out, int capacity);
+    Level level(Resource resource) const { return m_levels[resource]; }
+
+    static const char* resourceName(Resource resource);
+
+private:
+    struct PendingCreation {
+        int moduleType;
+        Usage before;
+        qint64 timestampMs;
+    };
+
+    static double valueOf(const Usage& usage, Resource resource);
+    static double limitOf(const Limits& limits, Resource resource);
+    static void blend(Cost* cost, double cpuPercent, double rssMB);
+
+    static constexpr double EWMA_ALPHA = 0.3;
+
+    QHash<int, Cost> m_costs;
+    Cost m_globalCost;
+    QList<PendingCreation> m_pending;
+    Level m_levels[RESOURCE_COUNT];
+};
+
+#endif // ADMISSIONCONTROLLER_H
@@ -0,0 +1,72 @@
+#ifndef BOARDVIRTUALIZER_H
+#define BOARDVIRTUALIZER_H
+
+#include <QList>
+#include <QRect>
+#include <QSet>
+#include "SpatialIndex.h"
+
+/**
+ * @brief 白板视口虚拟化的簿记（不涉及控件，MainWindow::updateVirtualization()使用）
+ *
+ * - 活动集合：与视口（四周加上margin）相交的键；update()返回相对上一次离开和进入的键
+ * - 重建队列：进入视口、需要重建内容的键；takeMaterializeBatch()每帧最多取出materializePerFrame个，
+ *   快速滚动时分摊到之后的帧
+ * - 已经离开视口或被remove()的键不会再从队列中取出
+ *
+ * update()只查询空间索引中与视口相交的键并遍历上一次的活动集合，与索引中的键总数无关。
+ * 键与SpatialIndex相同（卡槽ID）。只在GUI线程中使用。
+ */
+class BoardVirtualizer {
+public:
+    static const int DEFAULT_MARGIN = 300;               // 视口外保留内容的边距（像素）
+    static const int DEFAULT_MATERIALIZE_PER_FRAME = 8;
+
+    struct Changes {
+        QList<int> left;      // 离开视口（应停放）
+        QList<int> entered;   // 进入视口（应重新显示）
+    };
+
+    explicit BoardVirtualizer(int margin = DEFAULT_MARGIN,
+                              int materializePerFrame = DEFAULT_MATERIALIZE_PER_FRAME);
+
+    // 视口（白板坐标）加上边距后的矩形，与它相交的键是活动的
+    QRect liveRect(const QRect& viewport) const;
+    // 按新的视口更新活动集合
+    Changes update(const SpatialIndex& index, const QRect& viewport);
+
+    // 进入视口的键需要重建内容时排队
+    void queueMaterialize(int key);
+    // 取出本帧要重建的键（最多materializePerFrame个）：跳过已离开视口的键，
+    // 以及needsMaterialize(key)返回false的键（不占用预算）
+    template<typename Pred>
+    QList<int> takeMaterializeBatch(Pred needsMaterialize) {
+        QList<int> batch;
+        while (batch.size() < m_materializePerFrame && !m_pendingMaterialize.isEmpty()) {
+            const int key = m_pendingMaterialize.takeFirst();
+            if (m_live.contains(key) && needsMaterialize(key)) {
+                batch.append(key);
+            }
+        }
+        return batch;
+    }
+    bool hasPendingMaterialize() const { return !m_pendingMaterialize.isEmpty(); }
+    int pendingMaterializeCount() const { return m_pendingMaterialize.size(); }
+
+    // 键被删除（卡槽移除）：从活动集合和重建队列中去掉
+    void remove(int key);
+    void clear();
+
+    bool isLive(int key) const { return m_live.contains(key); }
+    const QSet<int>& liveKeys() const { return m_live; }
+    int margin() const { return m_margin; }
+    int materializePerFrame() const { return m_materializePerFrame; }
+
+private:
+    int m_margin;
+    int m_materializePerFrame;
+    QSet<int> m_live;                  // 活动的键（模块未停放）
+    QList<int> m_pendingMaterialize;   // 已进入视口、等待重建内容的键
+};
+
+#endif // BOARDVIRTUALIZER_H
@@ -0,0 +1,105 @@
+#ifndef EVENTLOOPMONITOR_H
+#define EVENTLOOPMONITOR_H
+
+#include <QObject>
+#include <QEvent>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QString>
+#include <atomic>
+#include "LatencyHistogram.h"
+
+/**
+ * @brief GUI事件循环延迟监控
+ *
+ * - 由ModuleApplication::notify在每个事件分发前后调用，记录事件处理耗时
+ * - 用户交互期间以16ms间隔运行探测定时器，记录实际的帧间隔；空闲时自动停止
+ * - 单个事件处理超过预算时发出stallDetected，带上事件类型和接收者类名
+ * - isUiJanky()可在任意线程调用，供准入检查在界面已经卡顿时暂停创建模块
+ */
+class EventLoopMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    struct Stats {
+        quint64 count;
+        double p50Ms;
+        double p99Ms;
+        double maxMs;
+    };
+
+    explicit EventLoopMonitor(QObject *parent = nullptr);
+    ~EventLoopMonitor();
+
+    // 应用程序中唯一的实例（未创建时为nullptr）；任意线程可调用（指标导出线程在抓取时读取）
+    static EventLoopMonitor* instance();
+
+    // 由QApplication::notify调用；只有GUI线程的最外层事件会被计时，此时返回true
+    bool beginEvent(QObject* receiver, QEvent* event);
+    void endEvent();
+
+    // 预算配置
+    void setStallBudgetMs(int ms) { m_stallBudgetUs.store(qint64(ms) * 1000); }
+    int stallBudgetMs() const { return int(m_stallBudgetUs.load() / 1000); }
+    void setFrameBudgetMs(int ms) { m_frameBudgetUs.store(qint64(ms) * 1000); }
+    int frameBudgetMs() const { return int(m_frameBudgetUs.load() / 1000); }
+
+    // 统计查询（任意线程可调用）
+    Stats frameIntervalStats() const;
+    Stats eventDurationStats() const;
+    quint64 stallCount() const { return m_stallCount.load(); }
+    bool isUiJanky() const { return m_janky.load(); }
+
+    const LatencyHistogram& frameIntervalHistogram() const { return m_frameIntervals; }
+    const LatencyHistogram& eventDurationHistogram() const { return m_eventDurations; }
+
+    void reset();
+
+signals:
+    void stallDetected(QEvent::Type eventType, const QString& receiverClass, double durationMs);
+
+private slots:
+    void onFrameProbe();
+
+private:
+    static Stats statsOf(const LatencyHistogram& histogram);
+    static bool isActivityEvent(QEvent::Type type);
+    void updateJankState(qint64 nowNs);
+
+    // GUI线程在构造/析构时写入，其它线程读取：release/acquire保证读到的实例已构造完成
+    static std::atomic<EventLoopMonitor*> s_instance;
+
+    // 最近的帧间隔/卡顿时间点，用于判断当前是否卡顿
+    static const int RECENT_FRAMES = 64;
+    static const int RECENT_STALLS = 8;
+    static const qint64 IDLE_STOP_NS = 2000LL * 1000 * 1000;     // 2秒无交互后停止探测
+    static const qint64 JANK_WINDOW_NS = 3000LL * 1000 * 1000;   // 卡顿判断窗口3秒
+
+    QElapsedTimer m_clock;
+    QTimer* m_frameProbe;
+    Qt::HANDLE m_guiThread;
+
+    // 当前正在分发的事件（只在GUI线程访问）
+    int m_depth;
+    qint64 m_eventStartNs;
+    QEvent::Type m_eventType;
+    const QMetaObject* m_receiverMeta;
+
+    // 帧探测
+    qint64 m_lastProbeNs;
+    qint64 m_lastActivityNs;
+    qint64 m_recentFrameUs[RECENT_FRAMES];
+    int m_recentFrameHead;
+    int m_recentFrameCount;
+    qint64 m_recentStallNs[RECENT_STALLS];
+    int m_recentStallHead;
+
+    LatencyHistogram m_frameIntervals;
+    LatencyHistogram m_eventDurations;
+    std::atomic<quint64> m_stallCount;
+    std::atomic<qint64> m_stallBudgetUs;
+    std::atomic<qint64> m_frameBudgetUs;
+    std::atomic<bool> m_janky;
+};
+
+#endif // EVENTLOOPMONITOR_H
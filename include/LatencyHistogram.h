@@ -0,0 +1,45 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief 对数分桶的延迟直方图（单位: 微秒）
+ *
+ * - 每个2的幂区间再细分4个桶，相对误差约20%
+ * - 计数使用原子变量：记录在GUI线程，读取可以在任意线程
+ * - 记录过程不分配内存
+ */
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKETS = 4;
+    static const int BUCKET_COUNT = 116;   // 覆盖到约9分钟
+
+    LatencyHistogram();
+
+    void record(quint64 micros);
+    void reset();
+
+    quint64 count() const { return m_count.load(std::memory_order_relaxed); }
+    quint64 maxMicros() const { return m_max.load(std::memory_order_relaxed); }
+    quint64 sumMicros() const { return m_sum.load(std::memory_order_relaxed); }
+
+    // percentile取值0~100，返回所在桶的上界（不超过最大值）
+    quint64 percentileMicros(double percentile) const;
+
+    // 直接访问桶，用于导出
+    quint64 bucketCount(int index) const;
+    static quint64 bucketUpperBound(int index);
+    static int bucketFor(quint64 micros);
+
+private:
+    Q_DISABLE_COPY(LatencyHistogram)
+
+    std::atomic<quint64> m_buckets[BUCKET_COUNT];
+    std::atomic<quint64> m_count;
+    std::atomic<quint64> m_sum;
+    std::atomic<quint64> m_max;
+};
+
+#endif // LATENCYHISTOGRAM_H
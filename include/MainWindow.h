@@ -6,10 +6,13 @@
 #include <QLabel>
 #include <QMenuBar>
 #include <QList>
+#include <QHash>
 #include <QRect>
 #include <QPoint>
 #include <QMouseEvent>
 #include "modules/ModuleManager.h"
+#include "SpatialIndex.h"
+#include "BoardVirtualizer.h"
 
 /**
  * @brief 无限大的可拖拽白板widget
@@ -46,6 +49,8 @@ private:
  * - 可拖拽的白板区域
  * - 多个模块可以吸附到白板
  */
+class QScrollArea;
+
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
@@ -61,13 +66,10 @@ protected:
     void moveEvent(QMoveEvent *event) override;
 
 private slots:
-    // 模块创建
-    void onCreateExampleModule();
-    void onCreateCustomModule();
-
     // 模块事件处理
-    void onModuleCreated(ModuleBase* module);
-    void onModuleDestroyed(ModuleBase* module);
+    // 批量：一次创建/销毁操作只处理一次（布局、显示、回收卡槽都在同一遍中完成）
+    void onModulesCreated(const QList<ModuleHandle>& handles);
+    void onModulesDestroyed(const QList<ModuleHandle>& handles);
     void onModuleDetachRequested(ModuleBase* module);
     void onModuleReattachRequested(ModuleBase* module);
     void onModuleCloseRequested(ModuleBase* module);
@@ -76,10 +78,16 @@ private slots:
     // 白板移动处理
     void onBoardMoved(const QPoint& delta);
 
-    // 定时更新吸附模块位置
-    void updateAttachedModulesPosition();
+    // 把以顶层窗口吸附的模块移动到卡槽的当前位置（每帧最多一次）
+    void syncGeometry();
 
 private:
+    // 菜单项：创建T类型的模块（受性能限制时提示原因）
+    template<typename T>
+    void createModuleFromMenu();
+    // 菜单项：创建插件提供的模块（首次创建时加载插件库）
+    void createPluginModuleFromMenu(ModuleBase::ModuleType type);
+
     void setupUI();
     void setupMenuBar();
     void updateBoardGlobalRect();
@@ -89,36 +97,66 @@ private:
 
     // 卡槽结构
     struct Slot {
+        int id;                // 在m_slots和m_slotIndex中的键
         QWidget* widget;       // 卡槽widget
         QRect localRect;       // 卡槽在白板中的本地坐标
-        ModuleBase* module;    // 吸附的模块
+        ModuleHandle module;   // 吸附的模块（模块销毁后句柄解析为nullptr）
         bool isOccupied;       // 是否被占用
     };
 
-    // 创建临时卡槽
-    Slot* createTemporarySlot(const QRect& moduleRect);
+    // 在白板本地坐标localRect处创建被module占用的卡槽
+    Slot* createTemporarySlot(const QRect& localRect, ModuleHandle module);
     void removeSlot(Slot* slot);
+    void removeSlotsOf(ModuleHandle handle);
+    void removeSlotsOf(const QList<ModuleHandle>& handles);
+
+    // 放入白板的目标位置（白板本地坐标）：模块必须完全在白板内，靠近已有卡槽时吸附对齐，
+    // 且不能与已有卡槽重叠；不能放入时返回空矩形，因重叠而不能放入时overlapping为true。
+    // 只查询空间索引中附近的卡槽，与卡槽总数无关
+    QRect dropTargetFor(ModuleBase* module, bool* overlapping = nullptr);
+    QRect snapToNeighbors(const QRect& localRect) const;
+    // 拖拽时在白板上显示放入位置（rect为空时隐藏）
+    void showDropPreview(const QRect& localRect);
+
+    // 视口虚拟化：只有与视口（加上边距）相交的卡槽中的模块保留内容控件，其它模块停放
+    // （ModuleBase::park()，之后释放空闲堆内存）；进入视口的模块先显示截图，停放时休眠的内容
+    // 分帧重建（活动集合和每帧预算见BoardVirtualizer）。停放的模块仍占用外壳（见ModuleBase::park()），
+    // 所以内容控件的内存随可见模块数量增长，外壳的内存随模块总数增长
+    void updateVirtualization();
+    QRect visibleBoardRect() const;   // 视口在白板本地坐标中的矩形
+    ModuleBase* slotModule(int slotId) const;
+
+    // 几何同步：白板平移、主窗口移动/缩放、滚动时标记，在下一帧合并为一次syncGeometry()，
+    // 没有变化时不运行。白板上的模块都嵌入在白板中，随白板移动，不需要逐个同步
+    void markGeometryDirty();
 
     // UI组件
     QWidget* m_centralWidget;
+    QScrollArea* m_scrollArea;
     DraggableBoardWidget* m_boardWidget;  // 白板区域（可拖拽）
     QLabel* m_boardLabel;    // 白板提示标签
     QLabel* m_notificationLabel;  // 左上角通知标签
 
-    // 模块管理
+    // 模块管理（模块列表只由ModuleManager维护）
     ModuleManager* m_moduleManager;
 
-    // 所有模块列表（所有模块都是独立窗口）
-    QList<ModuleBase*> m_allModules;
+    // 卡槽：按ID保存，按模块查找；空间索引按白板本地坐标做命中测试、重叠检查和吸附查找
+    QHash<int, Slot*> m_slots;
+    QHash<ModuleHandle, int> m_slotByModule;
+    SpatialIndex m_slotIndex;
+    int m_nextSlotId;
+    QWidget* m_dropPreview;   // 拖拽时的放入位置预览
+    static const int SLOT_SNAP_DISTANCE = 16;   // 与已有卡槽的间距不超过该值时吸附对齐
 
-    // 卡槽列表
-    QList<Slot*> m_slots;
+    // 视口虚拟化：活动卡槽（模块未停放）和等待重建内容的卡槽，键与m_slotIndex相同
+    BoardVirtualizer m_virtualizer;
 
     // 白板的全局矩形
     QRect m_boardGlobalRect;
 
-    // 定时器用于更新吸附模块位置
-    QTimer* m_updateTimer;
+    // 几何同步
+    static const int GEOMETRY_SYNC_INTERVAL_MS = 16;   // 约60 FPS
+    QTimer* m_geometrySyncTimer;
 
     // 白板的初始大小（可以无限扩展）
     static const int BOARD_WIDTH = 3000;
@@ -0,0 +1,62 @@
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMap>
+#include <QString>
+#include "MetricsExposition.h"
+
+class QLocalServer;
+class QLocalSocket;
+class PerformanceMonitor;
+
+/**
+ * @brief 通过本地套接字（Unix域套接字 / Windows命名管道）导出Prometheus格式的指标
+ *
+ * - 服务端运行在独立线程中，抓取时只读取PerformanceMonitor/EventLoopMonitor的无锁快照，
+ *   不经过GUI线程，界面卡住时仍然可以抓取
+ * - 模块数量由GUI线程推送到导出线程，抓取时不访问ModuleManager
+ * - 同时支持HTTP客户端（curl --unix-socket PATH http://localhost/metrics）
+ *   和不发送请求的原始客户端（socat - UNIX-CONNECT:PATH）
+ *
+ * 默认不启用；设置环境变量MODULESYSTEM_METRICS_SOCKET后由ModuleManager启动。
+ */
+class MetricsExporter : public QObject {
+    Q_OBJECT
+
+public:
+    static const char* const SOCKET_ENV_VAR;
+
+    explicit MetricsExporter(PerformanceMonitor* monitor, QObject *parent = nullptr);
+    ~MetricsExporter();
+
+    // 开始监听：名字或绝对路径；只允许当前用户连接
+    bool listen(const QString& socketName);
+    QString fullServerName() const { return m_fullServerName; }
+
+    // GUI线程调用，异步转发到导出线程
+    void setModuleCount(const QString& typeName, int count);
+    void setHibernatedModuleCount(int count);
+
+private:
+    // 以下函数只在导出线程中调用
+    void handleConnection(QLocalSocket* socket);
+    void respond(QLocalSocket* socket, const QByteArray& request);
+    QByteArray renderMetrics() const;
+
+    // 不发送请求的客户端等待多久后直接输出
+    static const int RAW_CLIENT_WAIT_MS = 100;
+    static const int MAX_REQUEST_BYTES = 8192;
+
+    PerformanceMonitor* m_monitor;
+    QThread* m_thread;
+    QLocalServer* m_server;          // 属于导出线程
+    QString m_fullServerName;
+
+    // 只在导出线程访问
+    QMap<QString, int> m_moduleCounts;
+    int m_hibernatedModules;
+};
+
+#endif // METRICSEXPORTER_H
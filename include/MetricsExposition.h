@@ -0,0 +1,65 @@
+#ifndef METRICSEXPOSITION_H
+#define METRICSEXPOSITION_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include "LatencyHistogram.h"
+
+/**
+ * @brief Prometheus文本格式（0.0.4）的指标渲染
+ *
+ * 只依赖快照数据，不访问任何QObject，可以在任意线程调用，也便于测试。
+ * MetricsExporter在导出线程中填充Snapshot并调用render()。
+ */
+namespace MetricsExposition {
+
+// 延迟直方图的导出边界（秒），与LatencyHistogram的桶按上界向下归并
+const int LATENCY_BOUND_COUNT = 11;
+extern const double LATENCY_BOUNDS_SECONDS[LATENCY_BOUND_COUNT];
+
+struct Histogram {
+    quint64 cumulative[LATENCY_BOUND_COUNT];   // 不超过各边界的累计数量
+    quint64 count;
+    double sumSeconds;
+};
+
+struct ModuleCount {
+    QString typeName;
+    int count;
+};
+
+struct Snapshot {
+    // PerformanceMonitor
+    double cpuUsagePercent;
+    quint64 memoryUsedMB;
+    quint64 memoryTotalMB;
+    double memoryUsagePercent;
+    quint64 processMemoryMB;
+    bool memoryLimitedByCgroup;
+    bool cpuLimitedByCgroup;
+    double cpuLimitCores;
+
+    // EventLoopMonitor（hasEventLoop为false时不输出）
+    bool hasEventLoop;
+    Histogram eventDuration;
+    Histogram frameInterval;
+    quint64 stallCount;
+    bool uiJanky;
+
+    // ModuleManager
+    QList<ModuleCount> moduleCounts;
+    int hibernatedModules;
+};
+
+Snapshot emptySnapshot();
+
+// 把LatencyHistogram（微秒）折算为导出用的直方图
+Histogram histogramFrom(const LatencyHistogram& histogram);
+
+QByteArray render(const Snapshot& snapshot);
+
+} // namespace MetricsExposition
+
+#endif // METRICSEXPOSITION_H
@@ -0,0 +1,60 @@
+#ifndef METRICSHISTORY_H
+#define METRICSHISTORY_H
+
+#include <QtGlobal>
+
+/**
+ * @brief 固定容量的性能采样历史（环形缓冲区）
+ *
+ * - 存储空间是内联数组，追加和查询都不分配内存
+ * - 可按时间窗口计算最小/最大/平均/P95
+ * - 类型可平凡复制，可以整体通过SeqLock在线程间发布
+ */
+class MetricsHistory {
+public:
+    enum Metric {
+        CpuUsage,        // CPU使用率 (%)
+        MemoryUsage,     // 系统（或容器）内存使用率 (%)
+        ProcessMemory    // 进程常驻内存 (MB)
+    };
+
+    struct Sample {
+        double cpuUsagePercent;
+        double memoryUsagePercent;
+        double processMemoryMB;
+    };
+
+    struct WindowStats {
+        int count;       // 窗口内实际的样本数
+        double min;
+        double max;
+        double mean;
+        double p95;
+    };
+
+    // 按2秒一次采样，可保留5分钟的历史
+    static const int CAPACITY = 150;
+
+    MetricsHistory();
+
+    void append(const Sample& sample);
+    void clear();
+
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+    // ageIndex为0表示最新的样本
+    Sample at(int ageIndex) const;
+
+    // 统计最近windowSamples个样本（不足时使用全部样本）
+    WindowStats stats(Metric metric, int windowSamples) const;
+
+private:
+    static double value(const Sample& sample, Metric metric);
+
+    Sample m_samples[CAPACITY];
+    int m_head;      // 下一次写入的位置
+    int m_count;
+};
+
+#endif // METRICSHISTORY_H
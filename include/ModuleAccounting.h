@@ -0,0 +1,83 @@
+#ifndef MODULEACCOUNTING_H
+#define MODULEACCOUNTING_H
+
+#include <QtGlobal>
+#include <QList>
+#include <QString>
+
+/**
+ * @brief 按模块ID统计资源占用
+ *
+ * - 每个线程有一个 "当前模块" 标记，由Scope在分发事件时设置（见ModuleApplication::notify）
+ * - CPU时间：线程CPU时钟，嵌套时只计入最内层的模块（不重复计算）
+ * - 内存：替换全局operator new，当前模块不为空时累加分配的字节数和次数
+ *   （统计的是累计分配量，不是当前常驻量；对齐分配new(std::align_val_t)不计入）
+ * - ConstructionScope把模块构造函数中的分配也计入该模块
+ *
+ * 计数器带引用计数：模块在自己的事件处理中被销毁时，Scope结束前计数器仍然有效。
+ */
+class ModuleAccounting {
+public:
+    struct Counters;
+
+    struct Usage {
+        quint64 cpuTimeUs;        // 模块代码占用的CPU时间
+        quint64 allocatedBytes;   // 累计分配的字节数
+        quint64 allocationCount;  // 累计分配次数
+        quint64 eventCount;       // 分发给该模块的事件数
+    };
+
+    struct ModuleUsage {
+        int moduleId;
+        QString title;
+        Usage usage;
+    };
+
+    // 把当前线程的 "当前模块" 切换为counters，析构时恢复（counters为空时不做任何事）
+    class Scope {
+    public:
+        explicit Scope(Counters* counters);
+        ~Scope();
+
+    private:
+        Counters* m_counters;
+        Counters* m_previous;
+
+        Q_DISABLE_COPY(Scope)
+    };
+
+    // 在作用域内第一个注册的模块立即成为当前模块，用于统计构造函数中的分配
+    class ConstructionScope {
+    public:
+        ConstructionScope();
+        ~ConstructionScope();
+
+    private:
+        friend class ModuleAccounting;
+        Counters* m_counters;
+        Counters* m_previous;
+        ConstructionScope* m_outer;
+
+        Q_DISABLE_COPY(ConstructionScope)
+    };
+
+    // 模块注册（由ModuleBase构造/析构时调用）
+    static Counters* registerModule(int moduleId, const QString& title);
+    static void unregisterModule(int moduleId);
+
+    // 查询（任意线程可调用）
+    static Usage usageOf(int moduleId);
+    static Usage usageOf(const Counters* counters);
+    // 按累计分配量从高到低，最多count个（count <= 0 时返回全部）
+    static QList<ModuleUsage> topModules(int count);
+
+    // 由operator new调用
+    static void recordAllocation(quint64 bytes);
+
+private:
+    static void switchTo(Counters* counters);
+    static void acquire(Counters* counters);
+    static void release(Counters* counters);
+};
+
+#endif // MODULEACCOUNTING_H
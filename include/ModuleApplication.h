@@ -0,0 +1,36 @@
+#ifndef MODULEAPPLICATION_H
+#define MODULEAPPLICATION_H
+
+#include <QApplication>
+#include "EventLoopMonitor.h"
+#include "ModuleAccounting.h"
+
+class ModuleBase;
+
+/**
+ * @brief 带事件循环监控的应用程序类
+ *
+ * 重写notify，在每个事件分发前后通知EventLoopMonitor计时；
+ * 接收者属于某个模块时，事件处理期间的CPU时间和内存分配计入该模块（ModuleAccounting），
+ * 用户输入事件同时更新该模块的最近交互时间（用于选择休眠的模块）
+ */
+class ModuleApplication : public QApplication {
+    Q_OBJECT
+
+public:
+    ModuleApplication(int &argc, char **argv);
+    ~ModuleApplication();
+
+    EventLoopMonitor* eventLoopMonitor() const { return m_eventLoopMonitor; }
+
+    bool notify(QObject *receiver, QEvent *event) override;
+
+private:
+    // 接收者自身或其祖先中的模块（不属于任何模块时为nullptr）
+    static ModuleBase* owningModule(QObject* receiver);
+    static bool isInteractionEvent(QEvent::Type type);
+
+    EventLoopMonitor* m_eventLoopMonitor;
+};
+
+#endif // MODULEAPPLICATION_H
@@ -3,12 +3,37 @@
 
 #include <QObject>
 #include <QTimer>
+#include <QThread>
+#include <QElapsedTimer>
 #include <QString>
+#include <QStringList>
+#include <atomic>
+#include "AdmissionController.h"
+#include "EventLoopMonitor.h"
+#include "MetricsHistory.h"
+#include "ProcFs.h"
+#include "SeqLock.h"
 
 /**
  * @brief 性能监控类
  *
- * 监控系统的CPU和内存使用情况，用于智能限制模块创建
+ * 监控系统的CPU和内存使用情况，用于智能限制模块创建。
+ * 在Linux容器中运行时，阈值比较的是cgroup的memory.max/cpu.max配额。
+ *
+ * 线程模型：
+ * - 采样在独立的工作线程中进行，GUI线程不会因为系统调用或/proc读取卡顿
+ * - 最新指标通过SeqLock发布，getCurrentMetrics()只读快照，不阻塞
+ * - 新样本到达后GUI线程更新压力状态，警告/严重信号在GUI线程中发出
+ *
+ * 准入控制（AdmissionController，只在GUI线程使用）：
+ * - 学习每种模块类型创建后的内存/CPU增量，用 "当前值 + 预计增量" 判断能否创建
+ * - 压力状态带迟滞，同一次压力过程只发出一次警告/严重信号
+ *
+ * 最近的样本保存在固定容量的历史中，准入检查可以使用窗口统计值
+ * （平均/P95等），避免单次尖峰导致结果来回跳动。
+ *
+ * 界面事件循环的延迟由EventLoopMonitor统计，通过getUiLatency()查询；
+ * 界面已经卡顿时准入检查同样会拒绝创建新模块。
  */
 class PerformanceMonitor : public QObject {
     Q_OBJECT
@@ -20,48 +45,135 @@ public:
         quint64 memoryTotalMB;       // 总内存 (MB)
         double memoryUsagePercent;   // 内存使用率 (0-100)
         quint64 processMemoryMB;     // 当前进程内存使用 (MB)
+
+        // 容器(cgroup v2)限制：为true时上面的数值是相对容器配额计算的
+        bool memoryLimitedByCgroup;  // memoryTotalMB来自memory.max
+        bool cpuLimitedByCgroup;     // cpuUsagePercent相对cpu.max配额
+        double cpuLimitCores;        // cpu.max配额折算的核数
+    };
+
+    // 准入检查使用的统计方式
+    enum AdmissionStatistic {
+        Instant,    // 只看最新的样本（旧行为）
+        Minimum,
+        Mean,
+        P95,
+        Maximum
+    };
+
+    // 界面事件循环延迟
+    struct UiLatency {
+        EventLoopMonitor::Stats frameInterval;   // 帧间隔
+        EventLoopMonitor::Stats eventDuration;   // 单个事件处理耗时
+        quint64 stallCount;                      // 超出预算的事件数
+        bool janky;                              // 当前是否卡顿
     };
 
+    // 采样间隔
+    static const int SAMPLE_INTERVAL_MS = 2000;
+
     explicit PerformanceMonitor(QObject *parent = nullptr);
     ~PerformanceMonitor();
 
-    // 获取当前性能指标
-    PerformanceMetrics getCurrentMetrics();
+    // 获取当前性能指标（任意线程可调用，不阻塞）
+    PerformanceMetrics getCurrentMetrics() const;
+
+    // 获取界面事件循环延迟（没有ModuleApplication时各项为0）
+    UiLatency getUiLatency() const;
 
-    // 检查是否可以安全创建新模块
+    // 检查是否可以安全创建指定类型的新模块（GUI线程，只读取快照，不做I/O）
+    bool canCreateNewModule(int moduleType, QString* reason = nullptr);
+    // 不区分类型：使用所有类型的平均开销
     bool canCreateNewModule(QString* reason = nullptr);
+    // 批量创建：一次检查count个模块的预计总开销
+    bool canCreateNewModules(int moduleType, int count, QString* reason = nullptr);
+
+    // 模块创建成功后调用，用于学习该类型的开销（GUI线程）；批量创建时count为模块数量
+    void recordModuleCreation(int moduleType, int count = 1);
 
-    // 性能阈值配置
-    void setCPUThreshold(double percent) { m_cpuThreshold = percent; }
-    void setMemoryThreshold(double percent) { m_memoryThreshold = percent; }
-    void setProcessMemoryThreshold(quint64 mb) { m_processMemoryThreshold = mb; }
+    // 当前是否处于内存严重压力（系统内存或进程内存，带迟滞；GUI线程）
+    bool isMemoryCritical() const;
+    // 系统内存与进程内存中较高的压力等级（GUI线程）
+    AdmissionController::Level memoryPressure() const;
 
-    double cpuThreshold() const { return m_cpuThreshold; }
-    double memoryThreshold() const { return m_memoryThreshold; }
-    quint64 processMemoryThreshold() const { return m_processMemoryThreshold; }
+    // 已学习到的单个模块开销（GUI线程）
+    AdmissionController::Cost estimatedModuleCost(int moduleType) const { return m_admission.costOf(moduleType); }
+
+    // 历史查询：最近seconds秒内的统计值（任意线程可调用）
+    MetricsHistory metricsHistory() const;
+    MetricsHistory::WindowStats windowStats(MetricsHistory::Metric metric, int seconds) const;
+
+    // 准入检查的窗口配置（默认: 最近10秒的平均值）
+    void setAdmissionWindow(int seconds, AdmissionStatistic statistic);
+    int admissionWindowSeconds() const { return m_admissionWindowSeconds.load(); }
+    AdmissionStatistic admissionStatistic() const { return AdmissionStatistic(m_admissionStatistic.load()); }
+
+    // 界面卡顿时是否拒绝创建（默认开启）
+    void setUiJankGatingEnabled(bool enabled) { m_uiJankGating.store(enabled); }
+    bool isUiJankGatingEnabled() const { return m_uiJankGating.load(); }
+
+    // 性能阈值配置（可从任意线程设置，压力状态在下一次采样后更新）
+    void setCPUThreshold(double percent) { m_cpuThreshold.store(percent); }
+    void setMemoryThreshold(double percent) { m_memoryThreshold.store(percent); }
+    void setProcessMemoryThreshold(quint64 mb) { m_processMemoryThreshold.store(mb); }
+
+    double cpuThreshold() const { return m_cpuThreshold.load(); }
+    double memoryThreshold() const { return m_memoryThreshold.load(); }
+    quint64 processMemoryThreshold() const { return m_processMemoryThreshold.load(); }
 
 signals:
     void performanceWarning(const QString& message);
     void performanceCritical(const QString& message);
+    // 内存压力等级变化（包括下降），用于调整缓存大小
+    void memoryPressureChanged(AdmissionController::Level level);
 
 private:
+    // 以下函数只在采样线程中调用
     void updateMetrics();
     double getCPUUsage();
     quint64 getSystemMemoryUsed();
     quint64 getSystemMemoryTotal();
     quint64 getProcessMemoryUsage();
 
-    QTimer* m_updateTimer;
-    PerformanceMetrics m_currentMetrics;
+    // GUI线程：处理最新样本，更新学习数据和压力状态
+    void onSampleAvailable();
+
+    AdmissionController::Usage usageOf(const PerformanceMetrics& metrics) const;
+    AdmissionController::Limits currentLimits() const;
+
+    QThread* m_samplerThread;
+    QTimer* m_updateTimer;           // 属于采样线程
+    SeqLock<PerformanceMetrics> m_currentMetrics;
+
+    // 历史：采样线程维护工作副本，每次采样后整体发布
+    MetricsHistory m_history;
+    SeqLock<MetricsHistory> m_publishedHistory;
+
+    // 采样线程已通知GUI线程、但尚未处理（多次采样合并为一次处理）
+    std::atomic<bool> m_sampleScheduled;
+
+    // 准入控制（只在GUI线程访问）
+    AdmissionController m_admission;
+    QElapsedTimer m_admissionClock;
 
     // 性能阈值
-    double m_cpuThreshold;           // CPU阈值 (默认80%)
-    double m_memoryThreshold;        // 系统内存阈值 (默认85%)
-    quint64 m_processMemoryThreshold; // 进程内存阈值 (默认1GB)
+    std::atomic<double> m_cpuThreshold;           // CPU阈值 (默认80%)
+    std::atomic<double> m_memoryThreshold;        // 系统内存阈值 (默认85%)
+    std::atomic<quint64> m_processMemoryThreshold; // 进程内存阈值 (默认1GB)
+
+    // 准入检查窗口
+    std::atomic<int> m_admissionWindowSeconds;
+    std::atomic<int> m_admissionStatistic;
+    std::atomic<bool> m_uiJankGating;
 
-    // CPU使用率计算相关
+    // CPU使用率计算相关（只在采样线程中访问）
     quint64 m_lastCPUTime;
     quint64 m_lastSystemTime;
+
+#ifdef Q_OS_LINUX
+    // Linux: 复用/proc文件句柄的采样器
+    ProcFs::Sampler m_procSampler;
+#endif
 };
 
 #endif // PERFORMANCEMONITOR_H
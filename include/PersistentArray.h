@@ -0,0 +1,169 @@
+#ifndef PERSISTENTARRAY_H
+#define PERSISTENTARRAY_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief 不可变的稀疏数组（32叉基数树），修改时只复制变化的路径
+ *
+ * - PersistentArray本身不可修改，可以在线程间共享（通常通过RcuPointer发布）
+ * - Editor在一个版本的基础上修改：第一次写某个叶子时复制从根到该叶子的路径（O(log32 n)），
+ *   同一批修改中再次写入这些节点不再复制；snapshot()之后的修改重新开始复制，
+ *   因此已经取得的版本永远不会改变
+ * - 从未写入过的下标读取为T()，整棵子树不分配内存
+ *
+ * 下标应当比较紧凑（例如SlotMap的槽位下标），树的深度由最大下标决定。
+ */
+template<typename T>
+class PersistentArray {
+    static const int BITS = 5;
+    static const quint32 WIDTH = 1u << BITS;
+    static const quint32 MASK = WIDTH - 1;
+
+    struct Node {
+        quint64 edit;   // 创建该节点的Editor批次，只有同一批次可以原地修改
+    };
+    struct Leaf : Node {
+        T values[WIDTH];
+    };
+    struct Branch : Node {
+        std::shared_ptr<Node> children[WIDTH];
+    };
+
+public:
+    PersistentArray()
+        : m_depth(0)
+    {}
+
+    // 可寻址的下标范围（不是元素个数）
+    quint64 capacity() const { return m_root ? capacityOf(m_depth) : 0; }
+
+    const T& at(quint32 index) const {
+        static const T empty{};
+        if (!m_root || index >= capacityOf(m_depth)) {
+            return empty;
+        }
+        const Node* node = m_root.get();
+        for (int level = m_depth; level > 0; --level) {
+            node = static_cast<const Branch*>(node)->children[(index >> (BITS * level)) & MASK].get();
+            if (!node) {
+                return empty;
+            }
+        }
+        return static_cast<const Leaf*>(node)->values[index & MASK];
+    }
+
+    // 按下标顺序遍历已分配叶子中的值（包括其中未写入的T()），跳过未分配的子树
+    template<typename Func>
+    void forEach(Func func) const {
+        if (m_root) {
+            visit(m_root.get(), m_depth, func);
+        }
+    }
+
+    class Editor {
+    public:
+        explicit Editor(const PersistentArray& base = PersistentArray())
+            : m_root(base.m_root)
+            , m_depth(base.m_depth)
+            , m_edit(nextEdit())
+        {}
+
+        void set(quint32 index, const T& value) {
+            if (!m_root) {
+                m_root = newNode(0);
+                m_depth = 0;
+            }
+            while (index >= capacityOf(m_depth)) {
+                std::shared_ptr<Node> root = newNode(m_depth + 1);
+                static_cast<Branch*>(root.get())->children[0] = m_root;
+                m_root = root;
+                ++m_depth;
+            }
+
+            m_root = editable(m_root, m_depth);
+            Node* node = m_root.get();
+            for (int level = m_depth; level > 0; --level) {
+                std::shared_ptr<Node>& child = static_cast<Branch*>(node)->children[(index >> (BITS * level)) & MASK];
+                child = editable(child, level - 1);
+                node = child.get();
+            }
+            static_cast<Leaf*>(node)->values[index & MASK] = value;
+        }
+
+        // 当前内容的不可变版本；之后的set()不会影响它
+        PersistentArray snapshot() {
+            PersistentArray result;
+            result.m_root = m_root;
+            result.m_depth = m_depth;
+            m_edit = nextEdit();
+            return result;
+        }
+
+    private:
+        std::shared_ptr<Node> newNode(int level) const {
+            std::shared_ptr<Node> node;
+            if (level == 0) {
+                node = std::make_shared<Leaf>();
+            } else {
+                node = std::make_shared<Branch>();
+            }
+            node->edit = m_edit;
+            return node;
+        }
+
+        // 本批次创建的节点原地修改，其它节点（可能已被某个版本共享）先复制
+        std::shared_ptr<Node> editable(const std::shared_ptr<Node>& node, int level) const {
+            if (!node) {
+                return newNode(level);
+            }
+            if (node->edit == m_edit) {
+                return node;
+            }
+            std::shared_ptr<Node> copy;
+            if (level == 0) {
+                copy = std::make_shared<Leaf>(*static_cast<const Leaf*>(node.get()));
+            } else {
+                copy = std::make_shared<Branch>(*static_cast<const Branch*>(node.get()));
+            }
+            copy->edit = m_edit;
+            return copy;
+        }
+
+        static quint64 nextEdit() {
+            static std::atomic<quint64> s_nextEdit(1);
+            return s_nextEdit.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::shared_ptr<Node> m_root;
+        int m_depth;
+        quint64 m_edit;
+    };
+
+private:
+    static quint64 capacityOf(int depth) {
+        return quint64(WIDTH) << (BITS * depth);
+    }
+
+    template<typename Func>
+    static void visit(const Node* node, int level, Func& func) {
+        if (level == 0) {
+            for (const T& value : static_cast<const Leaf*>(node)->values) {
+                func(value);
+            }
+            return;
+        }
+        for (const std::shared_ptr<Node>& child : static_cast<const Branch*>(node)->children) {
+            if (child) {
+                visit(child.get(), level - 1, func);
+            }
+        }
+    }
+
+    std::shared_ptr<Node> m_root;
+    int m_depth;   // 0表示根就是叶子
+};
+
+#endif // PERSISTENTARRAY_H
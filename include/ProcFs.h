@@ -0,0 +1,140 @@
+#ifndef PROCFS_H
+#define PROCFS_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Linux /proc 读取工具
+ *
+ * 提供PerformanceMonitor在Linux上使用的采样后端：
+ * - 文件句柄只打开一次，之后每次采样用pread从偏移0重新读取
+ * - 解析器直接扫描固定大小的缓冲区，采样过程中不分配内存
+ * - 进程位于cgroup v2中且设置了memory.max/cpu.max时，按容器限制计算
+ */
+namespace ProcFs {
+
+// /proc/stat 第一行（所有CPU的汇总）
+struct CpuTimes {
+    quint64 total;   // 所有状态的jiffies之和
+    quint64 idle;    // idle + iowait
+};
+
+// /proc/meminfo 中关心的字段（单位KB）
+struct MemInfo {
+    quint64 totalKB;
+    quint64 availableKB;
+};
+
+// 解析函数：输入为原始文件内容，成功返回true
+bool parseCpuTimes(const char* data, qsizetype length, CpuTimes* out);
+bool parseMemInfo(const char* data, qsizetype length, MemInfo* out);
+bool parseStatmResident(const char* data, qsizetype length, quint64* residentPages);
+
+// cgroup v2 相关文件
+// /proc/self/cgroup 中的 "0::<path>" 行，path写入out（以'\0'结尾）
+bool parseCgroupPath(const char* data, qsizetype length, char* out, qsizetype capacity);
+// memory.max 等 "max" 或数字格式的文件；"max"时unlimited为true
+bool parseLimitValue(const char* data, qsizetype length, quint64* value, bool* unlimited);
+// cpu.max: "<quota|max> <period>"
+bool parseCpuMax(const char* data, qsizetype length, quint64* quotaUsec, quint64* periodUsec, bool* unlimited);
+// cpu.stat / memory.stat 中的 "<key> <value>" 行
+bool parseKeyedValue(const char* data, qsizetype length, const char* key, quint64* value);
+
+/**
+ * @brief 可重复读取的/proc文件句柄
+ */
+class File {
+public:
+    File();
+    ~File();
+
+    bool open(const char* path);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    // 从文件开头读取最多capacity-1字节，并以'\0'结尾；失败返回-1
+    qsizetype read(char* buffer, qsizetype capacity);
+
+private:
+    Q_DISABLE_COPY(File)
+
+    int m_fd;
+};
+
+/**
+ * @brief 基于/proc的系统指标采样器
+ *
+ * procRoot默认为"/proc"，cgroupRoot默认为"/sys/fs/cgroup"，
+ * 测试时可以指向一份预先准备的快照目录。
+ *
+ * 进程所在cgroup（或其祖先）设置了限制时，内存和CPU指标按
+ * 实际可用的容器配额计算，而不是整台主机。
+ */
+class Sampler {
+public:
+    explicit Sampler(const char* procRoot = "/proc", const char* cgroupRoot = "/sys/fs/cgroup");
+
+    bool isValid() const;
+
+    // CPU使用率，基于与上一次调用之间的差值；首次调用返回0
+    double cpuUsagePercent();
+    quint64 systemMemoryUsedMB();
+    quint64 systemMemoryTotalMB();
+    quint64 processMemoryMB();
+
+    // 与cpuUsagePercent相同，但使用指定的单调时钟时间（微秒），供测试注入
+    double cpuUsagePercentAt(quint64 monotonicUsec);
+
+    // cgroup限制信息（最近一次采样的结果）
+    bool hasCgroup() const { return m_hasCgroup; }
+    bool isMemoryLimited() const { return m_memoryLimited; }
+    bool isCpuLimited() const { return m_cpuLimited; }
+    double cpuLimitCores() const { return m_cpuLimitCores; }
+
+private:
+    bool readMemInfo(MemInfo* out);
+    void openCgroupFiles(const char* cgroupRoot);
+    void refreshMemoryLimit();
+    void refreshCpuLimit();
+    double hostCpuUsagePercent();
+    double cgroupCpuUsagePercent(quint64 monotonicUsec);
+
+    static const qsizetype BUFFER_SIZE = 4096;
+    static const qsizetype PATH_SIZE = 1024;
+    static const int MAX_CGROUP_LEVELS = 8;
+
+    File m_statFile;
+    File m_meminfoFile;
+    File m_statmFile;
+
+    char m_buffer[BUFFER_SIZE];
+    quint64 m_pageSize;
+
+    // 上一次的CPU计数
+    CpuTimes m_lastCpu;
+    bool m_hasLastCpu;
+
+    // cgroup v2: 叶子节点的用量文件
+    bool m_hasCgroup;
+    File m_memoryCurrentFile;
+    File m_memoryStatFile;
+    File m_cpuStatFile;
+
+    // 从叶子到根的各级限制文件（生效的是其中最小的限制）
+    File m_memoryMaxFiles[MAX_CGROUP_LEVELS];
+    File m_cpuMaxFiles[MAX_CGROUP_LEVELS];
+
+    bool m_memoryLimited;
+    quint64 m_memoryLimitBytes;
+    bool m_cpuLimited;
+    double m_cpuLimitCores;
+
+    // 上一次的cgroup CPU计数
+    quint64 m_lastCgroupUsageUsec;
+    quint64 m_lastCgroupSampleUsec;
+    bool m_hasLastCgroupCpu;
+};
+
+} // namespace ProcFs
+
+#endif // PROCFS_H
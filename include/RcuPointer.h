@@ -0,0 +1,79 @@
+#ifndef RCUPOINTER_H
+#define RCUPOINTER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+/**
+ * @brief 单写多读的RCU指针：发布不可变对象，读取方无等待
+ *
+ * - 写入方（只有一个线程）用publish()替换当前对象
+ * - 读取方load()得到当前对象的shared_ptr，不加锁、不重试；持有期间对象不会被修改或释放
+ * - publish()只等待正在执行中的load()（几条指令），不等待持有旧对象的读取方
+ *
+ * load()进入时在两个计数器之一中登记（按发布次数的奇偶选择）。publish()交换指针后，
+ * 翻转奇偶并等待旧计数器清零，再翻转一次等待另一个计数器清零：
+ * 交换之前读到旧指针的load()一定已经登记，两次等待之后旧的包装对象才能释放；
+ * 每次等待期间新进入的读取方登记在另一个计数器中，持续的读取不会让写入方一直等待。
+ */
+template<typename T>
+class RcuPointer {
+public:
+    RcuPointer()
+        : m_current(new Box{std::make_shared<const T>()})
+        , m_epoch(0)
+    {
+        m_readers[0].count.store(0);
+        m_readers[1].count.store(0);
+    }
+
+    ~RcuPointer() {
+        delete m_current.load();
+    }
+
+    // 任意线程可调用
+    std::shared_ptr<const T> load() const {
+        Readers& readers = m_readers[m_epoch.load() & 1u];
+        readers.count.fetch_add(1);
+        std::shared_ptr<const T> value = m_current.load()->value;
+        readers.count.fetch_sub(1, std::memory_order_release);
+        return value;
+    }
+
+    // 只能由唯一的写入线程调用
+    void publish(std::shared_ptr<const T> value) {
+        Box* old = m_current.exchange(new Box{std::move(value)});
+        synchronize();
+        synchronize();
+        delete old;
+    }
+
+private:
+    Q_DISABLE_COPY(RcuPointer)
+
+    struct Box {
+        std::shared_ptr<const T> value;
+    };
+
+    // 每个计数器独占一个缓存行，读取方之间不争用同一行
+    struct alignas(64) Readers {
+        std::atomic<int> count;
+    };
+
+    void synchronize() {
+        Readers& readers = m_readers[m_epoch.fetch_add(1) & 1u];
+        // 与load()构成Dekker式握手（读取方先登记再读指针，写入方先换指针再读计数），
+        // 两边都必须在seq_cst全序中，acquire读取可能看到登记之前的0
+        while (readers.count.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::atomic<Box*> m_current;
+    std::atomic<unsigned> m_epoch;
+    mutable Readers m_readers[2];
+};
+
+#endif // RCUPOINTER_H
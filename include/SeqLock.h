@@ -0,0 +1,79 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief 单写多读的顺序锁（seqlock）
+ *
+ * 用于在线程间发布小型的POD快照：
+ * - 写入方（只有一个线程）从不阻塞
+ * - 读取方从不加锁，也不会等待I/O；只有恰好与写入重叠时才重读一次
+ *
+ * 数据按64位字存放在原子变量中，读取过程不存在数据竞争。
+ */
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock()
+        : m_sequence(0)
+    {
+        T initial{};
+        store(initial);
+    }
+
+    // 只能由唯一的写入线程调用
+    void store(const T& value) {
+        quint64 words[WORD_COUNT] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const unsigned seq = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < WORD_COUNT; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        m_sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // 任意线程可调用
+    T load() const {
+        quint64 words[WORD_COUNT];
+        unsigned before;
+        unsigned after;
+        do {
+            before = m_sequence.load(std::memory_order_acquire);
+            for (int i = 0; i < WORD_COUNT; ++i) {
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = m_sequence.load(std::memory_order_relaxed);
+        } while ((before & 1u) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    // 已发布的版本数，可用于判断快照是否更新
+    unsigned version() const {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    Q_DISABLE_COPY(SeqLock)
+
+    static const int WORD_COUNT = int((sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64));
+
+    std::atomic<unsigned> m_sequence;
+    std::atomic<quint64> m_words[WORD_COUNT];
+};
+
+#endif // SEQLOCK_H
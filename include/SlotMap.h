@@ -0,0 +1,105 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <QtGlobal>
+#include <QList>
+
+/**
+ * @brief 带代数（generation）的槽位表
+ *
+ * - insert()返回一个键（槽位下标 + 代数），get()按键O(1)取值
+ * - remove()后槽位的代数递增，旧键立即失效，get()返回nullptr而不是悬空的值；
+ *   槽位会被之后的insert()复用，但旧键不会匹配新值
+ * - 值紧密存放在连续数组中（删除时用末尾元素填补空位），遍历时不需要跳过空洞，
+ *   但删除会改变遍历顺序，也会使指向值的指针失效
+ *
+ * Key需要有quint32类型的index和generation成员；代数为0的键为空键，不会匹配任何值。
+ */
+template<typename Key, typename T>
+class SlotMap {
+public:
+    Key insert(const T& value) {
+        quint32 slotIndex;
+        if (!m_freeSlots.isEmpty()) {
+            slotIndex = m_freeSlots.takeLast();
+        } else {
+            slotIndex = quint32(m_slots.size());
+            m_slots.append(Slot{0, 1});
+        }
+
+        Slot& slot = m_slots[slotIndex];
+        slot.denseIndex = quint32(m_values.size());
+        m_values.append(value);
+        m_denseToSlot.append(slotIndex);
+
+        Key key;
+        key.index = slotIndex;
+        key.generation = slot.generation;
+        return key;
+    }
+
+    bool remove(const Key& key) {
+        if (!contains(key)) {
+            return false;
+        }
+
+        Slot& slot = m_slots[key.index];
+        const quint32 denseIndex = slot.denseIndex;
+        const quint32 lastIndex = quint32(m_values.size() - 1);
+
+        // 用末尾的值填补空位
+        if (denseIndex != lastIndex) {
+            m_values[denseIndex] = m_values.at(lastIndex);
+            m_denseToSlot[denseIndex] = m_denseToSlot.at(lastIndex);
+            m_slots[m_denseToSlot.at(denseIndex)].denseIndex = denseIndex;
+        }
+        m_values.removeLast();
+        m_denseToSlot.removeLast();
+
+        // 代数递增使旧键失效；跳过0，空键永远不匹配
+        if (++slot.generation == 0) {
+            slot.generation = 1;
+        }
+        m_freeSlots.append(key.index);
+        return true;
+    }
+
+    bool contains(const Key& key) const {
+        return key.generation != 0 && key.index < quint32(m_slots.size()) &&
+               m_slots.at(key.index).generation == key.generation;
+    }
+
+    T* get(const Key& key) {
+        return contains(key) ? &m_values[m_slots.at(key.index).denseIndex] : nullptr;
+    }
+
+    const T* get(const Key& key) const {
+        return contains(key) ? &m_values.at(m_slots.at(key.index).denseIndex) : nullptr;
+    }
+
+    // 连续存储的值；下标与keyAt()对应
+    const QList<T>& values() const { return m_values; }
+    Key keyAt(int denseIndex) const {
+        const quint32 slotIndex = m_denseToSlot.at(denseIndex);
+        Key key;
+        key.index = slotIndex;
+        key.generation = m_slots.at(slotIndex).generation;
+        return key;
+    }
+
+    int size() const { return m_values.size(); }
+    bool isEmpty() const { return m_values.isEmpty(); }
+
+private:
+    struct Slot {
+        quint32 denseIndex;
+        quint32 generation;
+    };
+
+    QList<Slot> m_slots;
+    QList<T> m_values;
+    QList<quint32> m_denseToSlot;   // 值所在的槽位
+    QList<quint32> m_freeSlots;
+};
+
+#endif // SLOTMAP_H
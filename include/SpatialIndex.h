@@ -0,0 +1,72 @@
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QRect>
+
+/**
+ * @brief 矩形的均匀网格索引（白板坐标），用于卡槽的命中测试、重叠检查和吸附目标查找
+ *
+ * - 平面划分为cellSize×cellSize的格子，每个矩形登记在它覆盖的所有格子中
+ * - 查询只访问查询范围覆盖的格子：点查询O(1)，矩形查询O(覆盖的格子数 + 结果数)，
+ *   与索引中的矩形总数无关（前提是单个格子中的矩形数有界，白板上的卡槽互不重叠，满足这一点）
+ * - 矩形查询中跨多个格子的元素只在“它与查询矩形交集的左上角所在的格子”中报告一次，不需要去重
+ *
+ * 键由调用方分配（例如卡槽ID），同一个键只对应一个矩形。只在GUI线程中使用。
+ */
+class SpatialIndex {
+public:
+    static const int DEFAULT_CELL_SIZE = 256;
+
+    explicit SpatialIndex(int cellSize = DEFAULT_CELL_SIZE);
+
+    // 插入或更新（键已存在时替换矩形）；空矩形不登记
+    void insert(int key, const QRect& rect);
+    bool remove(int key);
+    void clear();
+
+    bool contains(int key) const { return m_rects.contains(key); }
+    QRect rect(int key) const { return m_rects.value(key); }
+    int count() const { return m_rects.size(); }
+
+    // 包含point的元素
+    QList<int> at(const QPoint& point) const;
+    // 与rect相交的元素
+    QList<int> intersecting(const QRect& rect) const;
+    // 是否有元素与rect相交（找到第一个就返回）
+    bool intersectsAny(const QRect& rect) const;
+    // 与rect间距不超过maxDistance的元素中最近的一个，没有时返回-1
+    int nearest(const QRect& rect, int maxDistance) const;
+
+    // 两个矩形之间的间距（像素，横纵间隙之和）；相交或相邻时为0
+    static int distance(const QRect& a, const QRect& b);
+
+private:
+    static quint64 cellKey(int column, int row) {
+        return (quint64(quint32(column)) << 32) | quint32(row);
+    }
+    int cellOf(int coordinate) const;
+
+    // 对rect覆盖的每个格子调用func(格子键, 列, 行)；func返回false时停止
+    template<typename Func>
+    void forEachCell(const QRect& rect, Func func) const {
+        const int lastColumn = cellOf(rect.right());
+        const int lastRow = cellOf(rect.bottom());
+        for (int row = cellOf(rect.top()); row <= lastRow; ++row) {
+            for (int column = cellOf(rect.left()); column <= lastColumn; ++column) {
+                if (!func(cellKey(column, row), column, row)) {
+                    return;
+                }
+            }
+        }
+    }
+
+    int m_cellSize;
+    QHash<quint64, QList<int>> m_cells;   // 格子 -> 覆盖该格子的键
+    QHash<int, QRect> m_rects;
+};
+
+#endif // SPATIALINDEX_H
@@ -0,0 +1,76 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Chrome/Perfetto格式的轻量级事件追踪
+ *
+ * 用法：
+ *   MS_TRACE_SCOPE("ModuleManager::registerModule");          // 记录整个作用域
+ *   MS_TRACE_SCOPE_ID("ModuleBase::attachToSlot", moduleId());  // 附带模块ID
+ *   MS_TRACE_INSTANT("ModuleBase::dragPositionChanged");      // 瞬时事件
+ *
+ * - 只有定义了MODULESYSTEM_TRACING（CMake选项MODULESYSTEM_TRACING=ON）时才会记录，
+ *   否则所有宏展开为空，不产生任何代码
+ * - 每个线程一个固定容量的环形缓冲区，记录时不加锁、不分配内存；写满后覆盖最旧的事件
+ * - 事件名必须是字符串字面量（只保存指针）
+ * - Trace::toJson()/dumpToFile()按需导出，可直接在chrome://tracing或ui.perfetto.dev中打开；
+ *   导出与记录并发时，正在写入的少量事件可能不完整
+ */
+
+#ifdef MODULESYSTEM_TRACING
+
+namespace Trace {
+
+// 每个线程保留的事件数
+const int EVENTS_PER_THREAD = 16384;
+
+// 单调时钟（纳秒，进程内起点）
+qint64 nowNs();
+
+// 记录一个完整的区间（Chrome "X" 事件）/ 瞬时事件（"i"）；arg < 0 表示不附带参数
+void complete(const char* name, qint64 startNs, qint64 endNs, int arg);
+void instant(const char* name, int arg);
+
+// 导出所有线程的事件
+QByteArray toJson();
+bool dumpToFile(const QString& path);
+void clear();
+
+class Scope {
+public:
+    explicit Scope(const char* name, int arg = -1)
+        : m_name(name), m_arg(arg), m_startNs(nowNs()) {}
+    ~Scope() { complete(m_name, m_startNs, nowNs(), m_arg); }
+
+private:
+    const char* m_name;
+    int m_arg;
+    qint64 m_startNs;
+
+    Q_DISABLE_COPY(Scope)
+};
+
+} // namespace Trace
+
+#define MS_TRACE_CONCAT_INNER(a, b) a##b
+#define MS_TRACE_CONCAT(a, b) MS_TRACE_CONCAT_INNER(a, b)
+
+#define MS_TRACE_SCOPE(name) Trace::Scope MS_TRACE_CONCAT(msTraceScope_, __LINE__)(name)
+#define MS_TRACE_SCOPE_ID(name, id) Trace::Scope MS_TRACE_CONCAT(msTraceScope_, __LINE__)(name, int(id))
+#define MS_TRACE_INSTANT(name) Trace::instant(name, -1)
+#define MS_TRACE_INSTANT_ID(name, id) Trace::instant(name, int(id))
+
+#else
+
+#define MS_TRACE_SCOPE(name) do {} while (0)
+#define MS_TRACE_SCOPE_ID(name, id) do {} while (0)
+#define MS_TRACE_INSTANT(name) do {} while (0)
+#define MS_TRACE_INSTANT_ID(name, id) do {} while (0)
+
+#endif // MODULESYSTEM_TRACING
+
+#endif // TRACE_H
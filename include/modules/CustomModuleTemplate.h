@@ -3,6 +3,8 @@
 
 #include "ModuleBase.h"
 
+class QTextEdit;
+
 /**
  * @brief 自定义模块模板
  *
@@ -11,10 +13,11 @@
  * 要创建自定义模块：
  * 1. 复制这个文件和对应的.cpp文件
  * 2. 重命名类名和文件名
- * 3. 实现 contentWidget() 方法来定义UI
- * 4. 实现 clear() 方法来清理状态
- * 5. 在 ModuleManager 中添加创建方法
- * 6. 在 MainWindow 中添加菜单项
+ * 3. 实现 buildContent() 方法来定义UI（需要在休眠后保留的状态实现 saveState()/restoreState()）
+ * 4. 实现 clear() 方法来清理状态（先调用 ModuleBase::clear()）
+ * 5. 提供 staticModuleType() 和 staticMenuText()
+ * 6. 把类加入 ModuleRegistry::Modules（ModuleRegistry.h），创建方法和菜单项会自动生成
+ * 7. 耗时的初始化放进 ModuleModel 子类的 load()，重写 createModel() 返回它（可选）
  */
 class CustomModuleTemplate : public ModuleBase {
     Q_OBJECT
@@ -24,12 +27,17 @@ public:
     ~CustomModuleTemplate();
 
     void clear() override;
-    QWidget* contentWidget() override;
 
     static ModuleType staticModuleType() { return Custom; }
+    static const char* staticMenuText() { return "Create Custom Module"; }
+
+protected:
+    QWidget* buildContent() override;
+    QVariantMap saveState() const override;
+    void restoreState(const QVariantMap& state) override;
 
 private:
-    QWidget* m_contentWidget;
+    QPointer<QTextEdit> m_textEdit;   // 属于内容控件，休眠后为空
 };
 
 #endif // CUSTOMMODULETEMPLATE_H
\ No newline at end of file
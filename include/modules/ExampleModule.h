@@ -3,6 +3,8 @@
 
 #include "ModuleBase.h"
 
+class QTextEdit;
+
 /**
  * @brief 示例模块
  *
@@ -16,12 +18,17 @@ public:
     ~ExampleModule();
 
     void clear() override;
-    QWidget* contentWidget() override;
 
     static ModuleType staticModuleType() { return Example; }
+    static const char* staticMenuText() { return "Create Example Module"; }
+
+protected:
+    QWidget* buildContent() override;
+    QVariantMap saveState() const override;
+    void restoreState(const QVariantMap& state) override;
 
 private:
-    QWidget* m_contentWidget;
+    QPointer<QTextEdit> m_textEdit;   // 属于内容控件，休眠后为空
 };
 
 #endif // EXAMPLEMODULE_H
\ No newline at end of file
@@ -5,6 +5,39 @@
 #include <QString>
 #include <QMouseEvent>
 #include <QTimer>
+#include <QVariantMap>
+#include <QPointer>
+#include <memory>
+#include "../ModuleAccounting.h"
+#include "ModuleHandle.h"
+#include "ModuleModel.h"
+
+class QVBoxLayout;
+class QLabel;
+class QThreadPool;
+template<typename T> class QFutureWatcher;
+
+class ModuleBase;
+
+/**
+ * @brief 属于某个模块、但嵌入白板时不在模块对象树中的容器控件（内容容器、白板宿主）
+ *
+ * ModuleApplication沿父对象查找事件所属的模块时通过它找到模块。
+ */
+class ModuleContainer : public QWidget {
+    Q_OBJECT
+
+public:
+    ModuleContainer(ModuleBase* module, QWidget* parent)
+        : QWidget(parent)
+        , m_module(module)
+    {}
+
+    ModuleBase* module() const { return m_module; }
+
+private:
+    ModuleBase* m_module;
+};
 
 /**
  * @brief 所有模块的基类
@@ -14,6 +47,14 @@
  * - 标题栏和关闭按钮
  * - 模块标识和类型
  * - 统一的生命周期管理
+ * - 休眠：内存紧张时保存状态并销毁内容控件，用户再次操作时透明重建
+ *
+ * 延迟构建：子类在buildContent()中创建内容控件，基类在首次显示或首次调用contentWidget()时
+ * 才调用它；在此之前模块只是一个只有ID、类型和标题的轻量外壳，构造函数中不要创建界面。
+ * 需要在休眠后保留的状态通过saveState()/restoreState()保存和恢复。
+ *
+ * 模型与界面分离：耗时的初始化放在createModel()返回的ModuleModel中，
+ * 异步创建时模型在线程池中构建，期间模块显示“加载中”占位控件。
  */
 class ModuleBase : public QWidget {
     Q_OBJECT
@@ -35,6 +76,10 @@ public:
         // 用户自定义类型从这里开始
         UserDefined = 1000  // 用户自定义模块类型的起始值
     };
+    Q_ENUM(ModuleType)
+
+    // 类型名称，例如 "Example"；用户自定义类型为 "UserDefined+N"
+    static QString moduleTypeName(ModuleType type);
 
     explicit ModuleBase(ModuleType type, const QString& title, QWidget *parent = nullptr);
     virtual ~ModuleBase();
@@ -42,48 +87,153 @@ public:
     ModuleType moduleType() const { return m_type; }
     QString moduleTitle() const { return m_title; }
     int moduleId() const { return m_id; }
+    // 由ModuleManager在注册时分配；未注册或已注销时为空句柄
+    ModuleHandle moduleHandle() const { return m_handle; }
+
+    // 资源统计：该模块的事件处理和构造函数占用的CPU时间与内存分配
+    ModuleAccounting::Counters* accountingCounters() const { return m_accounting; }
+    ModuleAccounting::Usage resourceUsage() const { return ModuleAccounting::usageOf(m_accounting); }
 
     // 静态方法用于模板
     static ModuleType staticModuleType() { return Example; }  // 默认实现，子类应该重写
 
-    // 纯虚函数，子类必须实现
+    // 纯虚函数，子类必须实现；子类应先调用ModuleBase::clear()（取消尚未完成的模型加载）。
+    // ModuleManager销毁/回收模块时自己先取消加载，不依赖这一点
     virtual void clear() = 0;
-    virtual QWidget* contentWidget() = 0;
+
+    // 内容控件（尚未构建时先构建，休眠中的模块会先被唤醒，加载中的模块会等待模型加载完成）
+    virtual QWidget* contentWidget();
+    bool isContentBuilt() const { return m_content != nullptr; }
+
+    // 首次显示前构建内容控件
+    void setVisible(bool visible) override;
 
     // 新架构：窗口模式 vs 嵌入模式切换
     void attachToSlot(const QRect& slotGlobalRect);  // 旧方法，兼容性保留
     void attachToBoard();                             // 切换到嵌入模式（无窗口框架）
-    void detachFromSlot();                            // 切换到窗口模式（有窗口框架）
+    void detachFromSlot();                            // 切换到窗口模式（有窗口框架），嵌入的模块先移出白板
     bool isAttached() const { return m_isAttached; }
 
+    // 嵌入白板：内容移入board中的宿主控件（board坐标localRect），浮动框架隐藏；
+    // 宿主没有原生窗口，白板平移/滚动时随之一起移动和绘制，不需要同步位置
+    void embedInto(QWidget* board, const QRect& localRect);
+    bool isEmbedded() const { return m_boardHost && m_body->parentWidget() == m_boardHost; }
+    // 离开白板：内容移回浮动框架，但不显示框架（白板销毁前调用）
+    void leaveBoard();
+
+    // 视口虚拟化（只对嵌入的模块）：离开白板视口时停放——缓存内容截图、休眠并隐藏白板宿主，
+    // 之后不再绘制和布局；回到视口时unpark()重新显示宿主，wake()之前显示缓存的截图
+    // （截图在全局QPixmapCache中，被淘汰后显示文字占位）。
+    // 停放时释放内容控件树和隐藏的浮动框架的原生窗口（拖出白板时再创建；停放的模块在视口外，不会被拖出）；
+    // 模块对象、m_body、宿主、布局、占位控件和保存的状态保留
+    bool park();
+    void unpark();
+    bool isParked() const { return m_parked; }
+
     // 获取内容widget（用于嵌入到白板）
     QWidget* getContentWidget();
 
     // 移动到指定全局位置
     void moveToGlobalPos(const QPoint& globalPos);
 
+    // 休眠：保存状态并销毁内容控件，显示轻量占位控件；返回是否进入休眠
+    // 不要在内容控件自身的事件处理中调用
+    bool hibernate();
+    // 唤醒：重建内容控件并恢复状态（点击/激活休眠中的模块时自动调用）
+    void wake();
+    bool isHibernated() const { return m_hibernated; }
+    // 休眠是否由park()引起（回到视口时才需要重建）；内存压力下ModuleManager休眠的模块不是
+    bool isHibernatedByPark() const { return m_hibernatedByPark; }
+
+    // 模型正在线程池中加载（显示占位控件）
+    bool isLoading() const { return m_loadWatcher != nullptr; }
+
+    // 最近一次用户交互的时间（单调时钟，毫秒），用于选择最久未使用的模块休眠
+    qint64 lastInteractionMs() const { return m_lastInteractionMs; }
+    void markInteraction() { m_lastInteractionMs = interactionClockMs(); }
+    static qint64 interactionClockMs();
+
 signals:
     void detachRequested(ModuleBase* module);
     void closeRequested(ModuleBase* module);
     void reattachRequested(ModuleBase* module);
     void dragPositionChanged(ModuleBase* module, const QPoint& globalPos);
+    void hibernationChanged(ModuleBase* module, bool hibernated);
+    void attachedChanged(ModuleBase* module, bool attached);
+    // 异步加载结束：succeeded为false表示被clear()取消
+    void loadFinished(ModuleBase* module, bool succeeded);
 
 protected:
+    // 创建内容控件：首次显示/首次调用contentWidget()时调用，唤醒时会再次调用，
+    // 因此不要在其它地方保存其中控件的裸指针（使用QPointer）
+    virtual QWidget* buildContent() { return nullptr; }
+    // 休眠前保存、唤醒后恢复的状态
+    virtual QVariantMap saveState() const { return QVariantMap(); }
+    virtual void restoreState(const QVariantMap& state) { Q_UNUSED(state); }
+    // 创建模型（GUI线程，应当很快）；没有耗时初始化的模块不需要模型
+    virtual std::shared_ptr<ModuleModel> createModel() { return nullptr; }
+    // 已加载的模型，buildContent()中使用；没有模型或尚未加载时为nullptr
+    ModuleModel* model() const { return m_modelLoaded ? m_model.get() : nullptr; }
+
+    // 创建内容控件并加入模块的布局（已存在时不做任何事）；通常由基类按需调用
+    void initializeContent();
+
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
     void moveEvent(QMoveEvent *event) override;
     bool event(QEvent *event) override;
+    // 嵌入时白板宿主收到的鼠标事件按模块自身的事件处理
+    bool eventFilter(QObject *watched, QEvent *event) override;
 
 private slots:
     void onMoveTimeout();
 
 private:
+    void setAttached(bool attached);
+
+    // ModuleManager回收到实例池前调用：隐藏窗口，恢复初始的窗口状态，换用新的ID和资源统计
+    void resetForPool();
+
+    // 异步加载（ModuleManager::createModuleAsync()调用）：在pool中加载模型，期间显示占位控件；
+    // 没有模型或模型已经加载时返回false
+    bool beginLoad(QThreadPool* pool);
+    void finishLoad();
+    void cancelLoad();
+    void showPlaceholder(const QString& text);
+    void removePlaceholder();
+    QString hibernatedText() const;
+    QString previewCacheKey() const { return QStringLiteral("module-preview-%1").arg(m_id); }
+
+    // ModuleManager::attachView()调用：视图接管无界面模块的ID（资源统计随之切换）和已加载的模型
+    void adoptHeadlessModule(int id, const std::shared_ptr<ModuleModel>& model);
+    static int allocateId() { return s_nextId++; }
+
     ModuleType m_type;
     QString m_title;
     int m_id;
+    ModuleHandle m_handle;
+    ModuleAccounting::Counters* m_accounting;  // 由ModuleAccounting注册表持有，析构时注销
     bool m_isAttached;            // 是否附着到槽位（新架构）
+
+    // 浮动框架（模块自身，始终是同一个顶层窗口）与白板宿主（首次嵌入时创建，属于白板）
+    QVBoxLayout* m_frameLayout;
+    ModuleContainer* m_body;                   // 内容容器，在框架和宿主之间移动
+    QPointer<ModuleContainer> m_boardHost;
+    bool m_parked;
+
+    // 内容与休眠
+    QVBoxLayout* m_rootLayout;                 // m_body的布局
+    QWidget* m_content;
+    QLabel* m_placeholder;
+    bool m_hibernated;
+    bool m_hibernatedByPark;
+    QVariantMap m_savedState;
+    std::shared_ptr<ModuleModel> m_model;      // 工作线程中的加载任务也持有引用
+    bool m_modelLoaded;
+    QFutureWatcher<void>* m_loadWatcher;
+    qint64 m_lastInteractionMs;            // 最近一次交互时间（单调时钟，毫秒）
     QRect m_attachedSlotRect;     // 附着的槽位全局矩形
 
     // 拖拽相关
@@ -95,6 +245,8 @@ private:
     QPoint m_lastMoveEventPos;    // 记录moveEvent的上一次位置
 
     static int s_nextId;
+
+    friend class ModuleManager;
 };
 
 #endif // MODULEBASE_H
\ No newline at end of file
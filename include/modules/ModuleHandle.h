@@ -0,0 +1,35 @@
+#ifndef MODULEHANDLE_H
+#define MODULEHANDLE_H
+
+#include <QtGlobal>
+#include <QHashFunctions>
+#include <QMetaType>
+
+/**
+ * @brief 模块句柄（ModuleManager槽位表的键）
+ *
+ * 代替裸ModuleBase*保存对模块的引用：通过ModuleManager::module()在O(1)内解析，
+ * 模块销毁（包括deleteLater尚未执行时）后解析返回nullptr。
+ * 默认构造的句柄为空句柄。
+ */
+struct ModuleHandle {
+    quint32 index = 0;
+    quint32 generation = 0;   // 0表示空句柄
+
+    bool isNull() const { return generation == 0; }
+
+    friend bool operator==(const ModuleHandle& a, const ModuleHandle& b) {
+        return a.index == b.index && a.generation == b.generation;
+    }
+    friend bool operator!=(const ModuleHandle& a, const ModuleHandle& b) {
+        return !(a == b);
+    }
+};
+
+inline size_t qHash(const ModuleHandle& handle, size_t seed = 0) {
+    return qHashMulti(seed, handle.index, handle.generation);
+}
+
+Q_DECLARE_METATYPE(ModuleHandle)
+
+#endif // MODULEHANDLE_H
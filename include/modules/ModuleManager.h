@@ -3,12 +3,25 @@
 
 #include <QObject>
 #include <QList>
+#include <QHash>
+#include <QTimer>
+#include <QFuture>
+#include <QPromise>
+#include <array>
 #include <memory>
+#include <type_traits>
 #include "ModuleBase.h"
-#include "ExampleModule.h"
-#include "CustomModuleTemplate.h"
+#include "ModuleHandle.h"
+#include "ModuleRegistry.h"
+#include "ModulePluginLoader.h"
+#include "ModuleSnapshot.h"
+#include "../RcuPointer.h"
+#include "../SlotMap.h"
 #include "../PerformanceMonitor.h"
 
+class MetricsExporter;
+class QThreadPool;
+
 /**
  * @brief 模块管理器
  *
@@ -17,7 +30,15 @@
  * 2. 管理模块数量限制
  * 3. 处理模块生命周期
  * 4. 提供模块查询功能
- * 5. 支持模块类型注册
+ * 5. 按ModuleRegistry中注册的类型分类存储
+ * 6. 内存严重不足时休眠最久未交互的模块
+ * 7. 按类型缓存销毁的模块实例，启动后在空闲时预先构造，创建时直接复用
+ * 8. 异步创建：在线程池中加载模块的模型，加载期间模块显示占位控件
+ * 9. 插件模块：启动时从清单发现插件提供的类型，首次创建时才加载插件库
+ * 10. 无界面模式：在QCoreApplication下只创建模块的模型（不创建任何控件），需要时再附加视图
+ * 11. 注册表快照：每次修改后发布不可变快照，其它线程无等待地读取
+ *
+ * 除snapshot()外只能在GUI线程中使用。
  */
 class ModuleManager : public QObject {
     Q_OBJECT
@@ -26,63 +47,353 @@ public:
     explicit ModuleManager(QObject *parent = nullptr);
     ~ModuleManager();
 
-    // 模块创建（会检查性能限制）
-    ExampleModule* createExampleModule(QString* performanceReason = nullptr);
-    CustomModuleTemplate* createCustomModule(QString* performanceReason = nullptr);
-
     // 获取性能监控器
     PerformanceMonitor* performanceMonitor() { return m_performanceMonitor; }
 
-    // 通用模块创建方法
+    // 没有QApplication（只有QCoreApplication）时为true：只能无界面创建模块，不能附加视图
+    bool isHeadless() const { return m_headless; }
+
+    // 指标导出：在本地套接字上提供Prometheus格式的指标（设置MODULESYSTEM_METRICS_SOCKET时自动启动）
+    bool startMetricsExporter(const QString& socketName);
+    MetricsExporter* metricsExporter() const { return m_metricsExporter; }
+
+    // 模块创建（会检查性能限制，不允许时返回nullptr并在performanceReason中说明原因）
     template<typename T>
-    T* createModule() {
-        // 检查是否达到限制
-        if (!canCreateModule(T::staticModuleType())) {
-            qWarning() << "[ModuleManager] Cannot create module: limit reached for type" << T::staticModuleType();
-            return nullptr;
+    T* createModule(QString* performanceReason = nullptr) {
+        const QList<T*> modules = createModules<T>(1, performanceReason);
+        return modules.isEmpty() ? nullptr : modules.first();
+    }
+
+    // 批量创建count个模块：一次性能检查（按count个模块的预计总开销），
+    // 全部注册后只发出一次modulesCreated；不允许时一个也不创建，返回空列表
+    template<typename T>
+    QList<T*> createModules(int count, QString* performanceReason = nullptr) {
+        return createModulesImpl<T>(count, performanceReason, false);
+    }
+
+    // 异步创建：立即注册并发出modulesCreated（模块显示“加载中”占位控件），
+    // 模型（ModuleModel::load()）在线程池中加载，完成后在GUI线程中构建内容控件。
+    // 返回的future在内容控件构建后给出模块句柄；被性能限制拒绝、或加载完成前模块被clear()/销毁时为取消状态。
+    // 没有模型的模块（或从实例池复用的模块）立即完成。
+    template<typename T>
+    QFuture<ModuleHandle> createModuleAsync(QString* performanceReason = nullptr) {
+        const QList<T*> modules = createModulesImpl<T>(1, performanceReason, true);
+        return loadFuture(modules.isEmpty() ? nullptr : modules.first());
+    }
+
+    // 无界面创建：只创建并加载模型（在加载线程池中并行加载，全部完成后返回），不创建任何控件，
+    // 可在QCoreApplication下使用。模块有ID、类型和句柄，module()返回nullptr，直到attachView()。
+    // T提供static std::shared_ptr<ModuleModel> staticCreateModel()时才有模型（见ModuleModel.h）
+    template<typename T>
+    QList<ModuleHandle> createHeadlessModules(int count, QString* performanceReason = nullptr) {
+        static_assert(std::is_base_of<ModuleBase, T>::value, "T must derive from ModuleBase");
+
+        QList<ModuleHandle> handles;
+        if (count <= 0) {
+            return handles;
         }
+        if (!m_performanceMonitor->canCreateNewModules(T::staticModuleType(), count, performanceReason)) {
+            qWarning() << "[ModuleManager] Cannot create" << count << "headless"
+                       << ModuleBase::moduleTypeName(T::staticModuleType())
+                       << "module(s) due to performance constraints";
+            return handles;
+        }
+
+        QList<std::shared_ptr<ModuleModel>> models;
+        models.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            if constexpr (HasStaticModel<T>::value) {
+                models.append(T::staticCreateModel());
+            } else {
+                models.append(nullptr);
+            }
+        }
+        loadModels(models);
 
-        T* module = new T();
-        registerModule(module);
-        return module;
+        handles.reserve(count);
+        for (const std::shared_ptr<ModuleModel>& model : models) {
+            handles.append(insertHeadlessModule(T::staticModuleType(), ModuleRegistry::indexOf<T>(),
+                                                model, &constructView<T>));
+        }
+        notifyModulesCreated(handles);
+        return handles;
     }
 
-    // 获取现有模块
-    QList<ModuleBase*> allModules() const;
-    QList<ModuleBase*> modulesByType(ModuleBase::ModuleType type) const;
-    ModuleBase* moduleById(int id) const;
+    template<typename T>
+    ModuleHandle createHeadlessModule(QString* performanceReason = nullptr) {
+        const QList<ModuleHandle> handles = createHeadlessModules<T>(1, performanceReason);
+        return handles.isEmpty() ? ModuleHandle() : handles.first();
+    }
+
+    // 为无界面模块创建视图（需要QApplication），视图沿用模块的ID和已加载的模型；
+    // 已有视图时直接返回，句柄无效或处于无界面模式时返回nullptr。成功后发出viewAttached
+    ModuleBase* attachView(ModuleHandle handle);
+
+    // 插件模块：类型来自插件清单（见ModulePluginInterface.h），首次创建时加载插件库；
+    // 失败（性能限制、插件加载失败）时返回nullptr/取消状态的future，并在reason中说明原因
+    ModuleBase* createPluginModule(ModuleBase::ModuleType type, QString* reason = nullptr);
+    QFuture<ModuleHandle> createPluginModuleAsync(ModuleBase::ModuleType type, QString* reason = nullptr);
+    ModulePluginLoader* pluginLoader() { return &m_pluginLoader; }
+
+    // 句柄解析（O(1)）；模块已销毁（包括deleteLater尚未执行）或没有视图时返回nullptr
+    ModuleBase* module(ModuleHandle handle) const;
+    bool contains(ModuleHandle handle) const { return m_modules.contains(handle); }
+    // 模块ID（包括无界面模块）；句柄无效时返回-1
+    int moduleId(ModuleHandle handle) const;
+    // 模块的模型（无界面模块或视图已加载的模型）；没有模型时返回nullptr
+    ModuleModel* model(ModuleHandle handle) const;
+    ModuleHandle handleById(int id) const;
+    ModuleBase* moduleById(int id) const { return module(handleById(id)); }
+
+    // 现有模块的句柄；删除模块时用末尾元素填补空位，不保持创建顺序
+    QList<ModuleHandle> allModules() const;
+    QList<ModuleHandle> modulesByType(ModuleBase::ModuleType type) const;
+
+    // 当前的注册表快照（任意线程可调用，无等待）；持有期间内容不变，修改注册表后发布新的快照
+    std::shared_ptr<const ModuleSnapshot> snapshot() const { return m_snapshot.load(); }
+
+    // 按连续存储顺序遍历所有有视图的模块（跳过无界面模块）；回调中不要创建或销毁模块
+    template<typename Func>
+    void forEachModule(Func func) const {
+        for (const ModuleEntry& entry : m_modules.values()) {
+            if (entry.module) {
+                func(entry.module);
+            }
+        }
+    }
+
+    // 资源统计：按模块ID查询CPU时间和内存分配；按占用从高到低排序的模块列表
+    ModuleAccounting::Usage moduleResourceUsage(int id) const;
+    QList<ModuleHandle> modulesByResourceUsage() const;
+
+    // 休眠：收到performanceCritical且内存处于严重压力时，分批休眠最久未交互的模块，
+    // 直到压力解除（默认开启）
+    void setHibernationEnabled(bool enabled);
+    bool isHibernationEnabled() const { return m_hibernationEnabled; }
+    // 休眠最多count个最久未交互的模块（跳过活动窗口和最近交互过的模块），返回实际数量
+    int hibernateLeastRecentlyUsed(int count);
+    int hibernatedModuleCount() const { return m_hibernatedCount; }
+    // 批量销毁内容控件（休眠、停放）之后调用：HEAP_TRIM_DELAY_MS内没有新的调用时释放一次空闲堆内存，
+    // 连续滚动时不在每一帧中扫描整个堆
+    void scheduleHeapTrim();
+    // 立即把空闲的堆内存还给系统（glibc的malloc_trim），RSS才会下降；其它平台什么也不做
+    static void releaseFreeHeap();
 
-    // 模块销毁
+    // 模块销毁（句柄立即失效）
+    void destroyModule(ModuleHandle handle);
     void destroyModule(ModuleBase* module);
+    // 批量销毁：全部注销后只发出一次modulesDestroyed；已失效的句柄被忽略
+    void destroyModules(const QList<ModuleHandle>& handles);
     void destroyAllModules();
 
     // 数量查询
-    int totalModuleCount() const { return m_allModules.size(); }
-    int exampleModuleCount() const { return m_exampleModules.size(); }
-    int customModuleCount() const { return m_customModules.size(); }
+    int totalModuleCount() const { return m_modules.size(); }
     int moduleCountByType(ModuleBase::ModuleType type) const;
 
+    // 注册表中某个模块类的数量（O(1)）
+    template<typename T>
+    int moduleCount() const {
+        static_assert(ModuleRegistry::isRegistered<T>(), "T is not in ModuleRegistry::Modules");
+        return m_modulesByType[ModuleRegistry::indexOf<T>()].size();
+    }
+
+    // 实例池：每种注册类型最多缓存的实例数（默认4，0表示不缓存）；
+    // 内存压力为Warning时减半，Critical时清空
+    void setPoolCapacity(int perType);
+    int poolCapacity() const { return m_poolCapacity; }
+    int effectivePoolCapacity() const;
+    int pooledModuleCount() const;
+    // 立即把每种类型的实例池补充到预热数量（通常由空闲时的定时器分步完成）
+    void prewarmPools();
+
 signals:
-    void moduleCreated(ModuleBase* module);
-    void moduleDestroyed(ModuleBase* module);
+    // 一次创建/销毁操作发出一次（单个模块时列表只有一个元素）
+    void modulesCreated(const QList<ModuleHandle>& handles);
+    // 无界面模块附加了视图
+    void viewAttached(ModuleHandle handle);
+    // 发出时句柄已经失效，只能用于比较
+    void modulesDestroyed(const QList<ModuleHandle>& handles);
+    // 每次操作每种受影响的类型发出一次
     void moduleTypeCountChanged(ModuleBase::ModuleType type, int count);
 
+private slots:
+    void onPerformanceCritical(const QString& message);
+    void onHibernationTick();
+    void onModuleHibernationChanged(ModuleBase* module, bool hibernated);
+    void onModuleAttachedChanged(ModuleBase* module, bool attached);
+    void publishHibernatedCount();
+    void onMemoryPressureChanged(AdmissionController::Level level);
+    void prewarmStep();
+    void onModuleLoadFinished(ModuleBase* module, bool succeeded);
+
 private:
-    bool canCreateModule(ModuleBase::ModuleType type) const;
-    void registerModule(ModuleBase* module);
-    void unregisterModule(ModuleBase* module);
+    static const int DEFAULT_POOL_CAPACITY = 4;
+    // 每种类型预先构造的实例数，以及启动后/复用后等待多久开始预热
+    static const int PREWARM_PER_TYPE = 2;
+    static const int PREWARM_STARTUP_DELAY_MS = 1000;
+    static const int PREWARM_IDLE_DELAY_MS = 200;
+
+    template<typename T>
+    QList<T*> createModulesImpl(int count, QString* performanceReason, bool loadAsync) {
+        static_assert(std::is_base_of<ModuleBase, T>::value, "T must derive from ModuleBase");
+
+        QList<T*> modules;
+        if (count <= 0 || !checkWidgetsAvailable(performanceReason)) {
+            return modules;
+        }
+        if (!m_performanceMonitor->canCreateNewModules(T::staticModuleType(), count, performanceReason)) {
+            qWarning() << "[ModuleManager] Cannot create" << count
+                       << ModuleBase::moduleTypeName(T::staticModuleType())
+                       << "module(s) due to performance constraints";
+            return modules;
+        }
+
+        QList<ModuleHandle> handles;
+        modules.reserve(count);
+        handles.reserve(count);
+        int constructed = 0;
+        for (int i = 0; i < count; ++i) {
+            T* module = takePooled<T>();
+            if (!module) {
+                module = constructModule<T>();
+                ++constructed;
+            }
+            handles.append(insertModule(module, ModuleRegistry::indexOf<T>()));
+            modules.append(module);
+            // 在通知之前开始加载，显示时已经是占位控件
+            if (loadAsync) {
+                startLoad(module);
+            }
+        }
+
+        // 复用的实例不占用新的资源，不参与开销学习；空闲时补充实例池
+        if (constructed > 0) {
+            m_performanceMonitor->recordModuleCreation(T::staticModuleType(), constructed);
+        }
+        if (constructed < count) {
+            schedulePrewarm(PREWARM_IDLE_DELAY_MS);
+        }
+
+        notifyModulesCreated(handles);
+        return modules;
+    }
+
+    ModuleBase* createPluginModuleImpl(ModuleBase::ModuleType type, QString* reason, bool loadAsync);
+
+    // 无界面模式下不能创建控件
+    bool checkWidgetsAvailable(QString* reason) const;
+    // 在加载线程池中并行加载（跳过空模型），全部完成后返回
+    void loadModels(const QList<std::shared_ptr<ModuleModel>>& models);
+
+    // 视图工厂：无界面模块附加视图时使用
+    typedef ModuleBase* (*ViewFactory)();
+    template<typename T>
+    static ModuleBase* constructView() {
+        ModuleAccounting::ConstructionScope accounting;
+        return new T();
+    }
+
+    // 异步加载：module没有需要加载的模型时不做任何事
+    void startLoad(ModuleBase* module);
+    QFuture<ModuleHandle> loadFuture(ModuleBase* module);
+
+    template<typename T>
+    T* constructModule() {
+        // 构造函数中创建界面的分配计入新模块
+        ModuleAccounting::ConstructionScope accounting;
+        return new T();
+    }
+
+    template<typename T>
+    T* takePooled() {
+        if constexpr (ModuleRegistry::isRegistered<T>()) {
+            QList<ModuleBase*>& pool = m_pools[ModuleRegistry::indexOf<T>()];
+            if (!pool.isEmpty()) {
+                // 池中的实例一定是T（按类型下标回收）
+                T* module = static_cast<T*>(pool.takeLast());
+                module->markInteraction();
+                return module;
+            }
+        }
+        return nullptr;
+    }
+
+    // 回收到实例池；不能回收（未注册类型、休眠中、池已满）时返回false
+    bool recycleModule(ModuleBase* module, int typeIndex);
+    void trimPools();
+    void schedulePrewarm(int delayMs);
+    int prewarmTarget() const { return qMin(PREWARM_PER_TYPE, effectivePoolCapacity()); }
+
+    // 每批休眠未休眠模块的比例，以及最近交互过的模块的保护时间
+    static const int HIBERNATION_BATCH_PERCENT = 25;
+    static const qint64 HIBERNATION_MIN_IDLE_MS = 30000;
+    static const int HEAP_TRIM_DELAY_MS = 300;
+
+    int hibernateBatch();
+
+    // 注册/注销只更新存储，不发出信号；由调用方在整批完成后统一通知
+    // typeIndex: ModuleRegistry中的下标，未注册类型为UNREGISTERED_INDEX
+    ModuleHandle insertModule(ModuleBase* module, int typeIndex);
+    ModuleHandle insertHeadlessModule(ModuleBase::ModuleType type, int typeIndex,
+                                      const std::shared_ptr<ModuleModel>& model, ViewFactory viewFactory);
+    void removeModule(ModuleHandle handle);
+    void notifyModulesCreated(const QList<ModuleHandle>& handles);
     void cleanupModule(ModuleBase* module);
+    void connectModule(ModuleBase* module);
+
+    // 快照：updateSnapshot()按注册表的当前内容改写一个槽位（已注销时清空），
+    // publishSnapshot()发布到目前为止的所有修改；只复制变化的路径
+    void updateSnapshot(ModuleHandle handle);
+    void publishSnapshot();
+
+    struct ModuleEntry {
+        ModuleBase* module;          // 视图；无界面模块为nullptr
+        int typeIndex;               // 所属类型桶
+        int typePosition;            // 在所属类型桶中的位置
+        int id;
+        ModuleBase::ModuleType type;
+        std::shared_ptr<ModuleModel> model;   // 无界面模块的模型（附加视图后交给视图持有）
+        ViewFactory viewFactory;              // 无界面模块创建视图的方法
+    };
 
-    // 模块存储
-    QList<ModuleBase*> m_allModules;
-    QList<ExampleModule*> m_exampleModules;
-    QList<CustomModuleTemplate*> m_customModules;
+    // 模块存储：唯一的数据源，注册/注销/句柄解析/按ID查询都是O(1)
+    SlotMap<ModuleHandle, ModuleEntry> m_modules;
+    QHash<int, ModuleHandle> m_handlesById;
+    // 类型桶：每个注册的模块类一个（大小即该类型的数量），最后一个存放未注册的类型
+    std::array<QList<ModuleHandle>, ModuleRegistry::TYPE_COUNT + 1> m_modulesByType;
+    QHash<ModuleBase::ModuleType, int> m_unregisteredCounts;         // 未注册类型按类型计数
+    int m_hibernatedCount;
 
-    // 类型计数器
-    QMap<ModuleBase::ModuleType, int> m_typeCounts;
+    // 注册表快照：m_snapshotEditor累积修改，publishSnapshot()时发布到m_snapshot
+    PersistentArray<ModuleInfo>::Editor m_snapshotEditor;
+    quint64 m_snapshotVersion;
+    RcuPointer<ModuleSnapshot> m_snapshot;
+
+    bool m_headless;
 
     // 性能监控
     PerformanceMonitor* m_performanceMonitor;
+
+    // 指标导出（未启用时为nullptr）
+    MetricsExporter* m_metricsExporter;
+
+    // 休眠
+    QTimer* m_hibernationTimer;
+    bool m_hibernationEnabled;
+    QTimer* m_heapTrimTimer;   // 合并堆内存释放（单次，每次调用重新计时）
+
+    // 实例池：每个注册的模块类一个，只存放已经clear()并隐藏的实例
+    std::array<QList<ModuleBase*>, ModuleRegistry::TYPE_COUNT> m_pools;
+    int m_poolCapacity;
+    AdmissionController::Level m_memoryPressure;
+    QTimer* m_prewarmTimer;
+
+    // 异步加载：模型加载线程池，以及尚未完成的加载（按模块，注销后仍可能收到取消通知）
+    QThreadPool* m_loadPool;
+    QHash<ModuleBase*, std::shared_ptr<QPromise<ModuleHandle>>> m_pendingLoads;
+
+    // 插件模块类型（使用未注册类型的存储桶）
+    ModulePluginLoader m_pluginLoader;
 };
 
 #endif // MODULEMANAGER_H
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef MODULEMODEL_H
+#define MODULEMODEL_H
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief 模块的模型部分（与界面无关的数据）
+ *
+ * 耗时的初始化（读取文件、解析、预计算）放在load()中：
+ * - ModuleManager::createModuleAsync()在线程池中调用load()，完成后才在GUI线程中构建内容控件
+ * - 同步创建的模块在首次构建内容控件前直接在GUI线程中调用load()
+ *
+ * load()中不能访问任何控件或模块对象，只能使用模型自己的数据；
+ * 应当定期检查isCancelled()，模块被clear()/销毁时尽早返回。
+ * 模型在休眠时保留，唤醒只重建内容控件。工作线程中的分配不计入模块的资源统计。
+ *
+ * 需要无界面运行（ModuleManager::createHeadlessModules()）的模块类提供
+ *   static std::shared_ptr<ModuleModel> staticCreateModel();
+ * 并在createModel()中返回它，这样不创建控件也能得到模型。
+ */
+class ModuleModel {
+public:
+    virtual ~ModuleModel() = default;
+
+    virtual void load() = 0;
+
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> m_cancelled{false};
+};
+
+// 模块类是否提供static staticCreateModel()
+template<typename T, typename = void>
+struct HasStaticModel : std::false_type {};
+
+template<typename T>
+struct HasStaticModel<T, std::void_t<decltype(T::staticCreateModel())>> : std::true_type {};
+
+#endif // MODULEMODEL_H
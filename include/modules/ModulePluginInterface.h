@@ -0,0 +1,43 @@
+#ifndef MODULEPLUGININTERFACE_H
+#define MODULEPLUGININTERFACE_H
+
+#include <QtPlugin>
+#include "ModuleBase.h"
+
+/**
+ * @brief 模块插件接口
+ *
+ * 模块类型可以编译成独立的共享库（.so/.dylib/.dll），放在插件目录中，不需要重新编译主程序。
+ * 每个插件库旁边放一个清单文件（*.json），主程序启动时只读取清单来生成菜单项，
+ * 创建该插件的第一个模块时才加载库。清单格式：
+ *
+ *   {
+ *       "library": "SamplePlugin",          // 库文件名，相对清单所在目录，可省略前缀和后缀
+ *       "modules": [
+ *           { "type": 1001, "name": "Sample", "menuText": "Create Sample Module" }
+ *       ]
+ *   }
+ *
+ * type必须不小于ModuleBase::UserDefined，且不能与内置类型或其它插件重复。
+ *
+ * 插件类同时继承QObject和本接口：
+ *   class SamplePlugin : public QObject, public ModulePluginInterface {
+ *       Q_OBJECT
+ *       Q_PLUGIN_METADATA(IID ModulePluginInterface_iid)
+ *       Q_INTERFACES(ModulePluginInterface)
+ *       ...
+ *   };
+ */
+class ModulePluginInterface {
+public:
+    virtual ~ModulePluginInterface() = default;
+
+    // 创建指定类型的模块（GUI线程）；不支持该类型时返回nullptr
+    // 与内置模块一样，构造函数中不要创建界面（见ModuleBase::buildContent()）
+    virtual ModuleBase* createModule(ModuleBase::ModuleType type) = 0;
+};
+
+#define ModulePluginInterface_iid "com.modulesystem.ModulePluginInterface/1.0"
+Q_DECLARE_INTERFACE(ModulePluginInterface, ModulePluginInterface_iid)
+
+#endif // MODULEPLUGININTERFACE_H
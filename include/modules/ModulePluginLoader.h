@@ -0,0 +1,70 @@
+#ifndef MODULEPLUGINLOADER_H
+#define MODULEPLUGINLOADER_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <memory>
+#include <vector>
+#include "ModuleBase.h"
+
+class QPluginLoader;
+class ModulePluginInterface;
+
+/**
+ * @brief 插件模块类型的发现与延迟加载
+ *
+ * - scanDirectory()只读取目录中的清单文件（*.json，格式见ModulePluginInterface.h），不加载任何库
+ * - createModule()首次创建某个插件的模块时才加载该插件的库，之后直接使用已加载的实例
+ * - 已加载的库在进程结束前不卸载（插件模块的代码和元对象都在库中）
+ *
+ * 只在GUI线程中使用。
+ */
+class ModulePluginLoader {
+public:
+    // 插件目录（多个目录用路径分隔符分隔）；另外总是扫描程序所在目录下的plugins目录
+    static const char* const PLUGIN_PATH_ENV_VAR;
+
+    struct TypeInfo {
+        ModuleBase::ModuleType type;
+        QString name;
+        QString menuText;
+        QString libraryPath;
+    };
+
+    ModulePluginLoader();
+    ~ModulePluginLoader();
+
+    // 读取目录中的清单，返回新发现的模块类型数；无效或重复的条目会被跳过
+    int scanDirectory(const QString& path);
+    // 扫描默认目录和PLUGIN_PATH_ENV_VAR中的目录
+    int scanDefaultDirectories();
+
+    // 按发现顺序的插件模块类型
+    QList<TypeInfo> types() const;
+    bool hasType(ModuleBase::ModuleType type) const { return m_typeIndex.contains(type); }
+    QString typeName(ModuleBase::ModuleType type) const;
+    // 提供该类型的库是否已经加载
+    bool isLoaded(ModuleBase::ModuleType type) const;
+
+    // 创建插件模块（需要时先加载库）；失败时返回nullptr并在error中说明原因
+    ModuleBase* createModule(ModuleBase::ModuleType type, QString* error = nullptr);
+
+private:
+    struct Plugin {
+        QString libraryPath;
+        std::unique_ptr<QPluginLoader> loader;   // 尚未加载时为空
+        ModulePluginInterface* instance;
+        bool failed;                             // 加载失败后不再重试
+    };
+
+    ModulePluginInterface* load(Plugin& plugin, QString* error);
+
+    std::vector<Plugin> m_plugins;
+    QList<TypeInfo> m_types;
+    QHash<ModuleBase::ModuleType, int> m_typeIndex;     // 类型 -> m_types中的下标
+    QHash<QString, int> m_pluginIndex;                  // 库路径 -> m_plugins中的下标
+    QHash<ModuleBase::ModuleType, int> m_typePlugin;    // 类型 -> m_plugins中的下标
+};
+
+#endif // MODULEPLUGINLOADER_H
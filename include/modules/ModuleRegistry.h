@@ -0,0 +1,112 @@
+#ifndef MODULEREGISTRY_H
+#define MODULEREGISTRY_H
+
+#include "ModuleBase.h"
+#include "ExampleModule.h"
+#include "CustomModuleTemplate.h"
+
+/**
+ * @brief 编译期模块类型注册表
+ *
+ * 新增模块类型时只需把模块类加入下面的ModuleRegistry::Modules，
+ * ModuleManager的工厂与按类型存储、MainWindow的菜单项都由它在编译期生成。
+ *
+ * 注册的模块类需要提供：
+ * - 默认构造函数
+ * - static ModuleType staticModuleType()   模块类型（注册表中不能重复）
+ * - static const char* staticMenuText()    创建菜单项的文字
+ *
+ * 未注册的ModuleBase子类（测试模块等）仍然可以通过ModuleManager::createModule<T>()创建，
+ * 它们共用一个“未注册类型”的存储桶。
+ */
+
+template<typename... ModuleClasses>
+struct ModuleTypeList {
+    static constexpr int size = sizeof...(ModuleClasses);
+};
+
+// 在泛型lambda中传递模块类：using Module = typename decltype(tag)::Type;
+template<typename T>
+struct ModuleTypeTag {
+    using Type = T;
+};
+
+namespace ModuleRegistry {
+
+// 内置模块类型
+using Modules = ModuleTypeList<
+    ExampleModule,
+    CustomModuleTemplate
+>;
+
+namespace detail {
+
+// T在列表中的位置；不在列表中时为列表长度
+template<typename T, typename... Rest>
+struct IndexOf {
+    static constexpr int value = 0;
+};
+
+template<typename T, typename... Rest>
+struct IndexOf<T, T, Rest...> {
+    static constexpr int value = 0;
+};
+
+template<typename T, typename First, typename... Rest>
+struct IndexOf<T, First, Rest...> {
+    static constexpr int value = 1 + IndexOf<T, Rest...>::value;
+};
+
+template<typename List>
+struct Expand;
+
+template<typename... ModuleClasses>
+struct Expand<ModuleTypeList<ModuleClasses...>> {
+    template<typename T>
+    static constexpr int indexOf() { return IndexOf<T, ModuleClasses...>::value; }
+
+    template<typename Func>
+    static void forEach(Func&& func) {
+        (func(ModuleTypeTag<ModuleClasses>()), ...);
+    }
+
+    static int indexOfType(ModuleBase::ModuleType type) {
+        int index = 0;
+        // 短路求值：找到后停止
+        const bool found = ((ModuleClasses::staticModuleType() == type || (++index, false)) || ...);
+        return found ? index : int(sizeof...(ModuleClasses));
+    }
+};
+
+} // namespace detail
+
+const int TYPE_COUNT = Modules::size;
+
+// 未注册类型的存储桶下标
+const int UNREGISTERED_INDEX = TYPE_COUNT;
+
+// 模块类在注册表中的下标；未注册的类返回UNREGISTERED_INDEX
+template<typename T>
+constexpr int indexOf() {
+    return detail::Expand<Modules>::indexOf<T>();
+}
+
+template<typename T>
+constexpr bool isRegistered() {
+    return indexOf<T>() < TYPE_COUNT;
+}
+
+// 按注册顺序对每个模块类调用func(ModuleTypeTag<T>())
+template<typename Func>
+void forEachType(Func&& func) {
+    detail::Expand<Modules>::forEach(func);
+}
+
+// 运行时类型对应的下标；未注册的类型返回UNREGISTERED_INDEX
+inline int indexOfType(ModuleBase::ModuleType type) {
+    return detail::Expand<Modules>::indexOfType(type);
+}
+
+} // namespace ModuleRegistry
+
+#endif // MODULEREGISTRY_H
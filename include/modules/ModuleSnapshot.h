@@ -0,0 +1,72 @@
+#ifndef MODULESNAPSHOT_H
+#define MODULESNAPSHOT_H
+
+#include <QList>
+#include <QString>
+#include "../PersistentArray.h"
+#include "ModuleBase.h"
+#include "ModuleHandle.h"
+
+/**
+ * @brief 模块注册表的不可变快照，可在任意线程读取
+ *
+ * ModuleManager每次修改注册表（创建、销毁、休眠、加载完成、附着状态变化）后发布新的快照，
+ * ModuleManager::snapshot()无等待地取得当前快照。快照只包含值（ID、类型、标题、状态），
+ * 不包含模块指针；需要操作模块时把句柄交回GUI线程，用ModuleManager::module()解析。
+ */
+struct ModuleInfo {
+    enum StateFlag {
+        HasView    = 0x1,   // 有视图（无界面模块没有）
+        Loading    = 0x2,   // 模型正在线程池中加载
+        Hibernated = 0x4,
+        Attached   = 0x8    // 嵌入白板（否则为独立窗口）
+    };
+
+    ModuleHandle handle;    // 空句柄表示空位
+    int id = -1;
+    ModuleBase::ModuleType type = ModuleBase::Example;
+    QString title;          // 无界面模块为空（标题由视图的构造函数设置）
+    quint32 flags = 0;
+
+    bool isNull() const { return handle.isNull(); }
+    bool testFlag(StateFlag flag) const { return (flags & flag) != 0; }
+};
+
+class ModuleSnapshot {
+public:
+    // 每次发布递增，可用于判断注册表是否变化
+    quint64 version() const { return m_version; }
+    int count() const { return m_count; }
+
+    // O(log n)；句柄在该快照中无效时返回nullptr
+    const ModuleInfo* find(ModuleHandle handle) const {
+        const ModuleInfo& info = m_modules.at(handle.index);
+        return !handle.isNull() && info.handle == handle ? &info : nullptr;
+    }
+
+    // 按槽位顺序遍历所有模块
+    template<typename Func>
+    void forEach(Func func) const {
+        m_modules.forEach([&func](const ModuleInfo& info) {
+            if (!info.isNull()) {
+                func(info);
+            }
+        });
+    }
+
+    QList<ModuleInfo> modules() const {
+        QList<ModuleInfo> result;
+        result.reserve(m_count);
+        forEach([&result](const ModuleInfo& info) { result.append(info); });
+        return result;
+    }
+
+private:
+    friend class ModuleManager;
+
+    PersistentArray<ModuleInfo> m_modules;   // 下标为句柄的槽位下标
+    int m_count = 0;
+    quint64 m_version = 0;
+};
+
+#endif // MODULESNAPSHOT_H
@@ -0,0 +1,57 @@
+#include "SamplePlugin.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QDebug>
+
+SampleModule::SampleModule(QWidget *parent)
+    : ModuleBase(staticModuleType(), "Sample Module (Plugin)", parent)
+    , m_clicks(0)
+{
+    qDebug() << "[SampleModule" << moduleId() << "] Created";
+}
+
+void SampleModule::clear() {
+    ModuleBase::clear();   // 取消尚未完成的模型加载
+    m_clicks = 0;
+    if (m_counterLabel) {
+        m_counterLabel->setText("Clicks: 0");
+    }
+}
+
+QWidget* SampleModule::buildContent() {
+    QWidget* content = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(content);
+
+    QLabel* titleLabel = new QLabel("Sample Plugin Module");
+    titleLabel->setStyleSheet("font-weight: bold; font-size: 14px; margin-bottom: 10px;");
+    layout->addWidget(titleLabel);
+
+    QLabel* descLabel = new QLabel("This module is loaded from a plugin library.\n"
+                                   "The library is loaded when the first module is created.");
+    descLabel->setWordWrap(true);
+    layout->addWidget(descLabel);
+
+    QLabel* counterLabel = new QLabel(QString("Clicks: %1").arg(m_clicks));
+    m_counterLabel = counterLabel;
+    layout->addWidget(counterLabel);
+
+    QPushButton* button = new QPushButton("Click Me!");
+    connect(button, &QPushButton::clicked, this, [this]() {
+        ++m_clicks;
+        if (m_counterLabel) {
+            m_counterLabel->setText(QString("Clicks: %1").arg(m_clicks));
+        }
+    });
+    layout->addWidget(button);
+    layout->addStretch();
+
+    return content;
+}
+
+ModuleBase* SamplePlugin::createModule(ModuleBase::ModuleType type) {
+    if (type == SampleModule::staticModuleType()) {
+        return new SampleModule();
+    }
+    return nullptr;
+}
@@ -0,0 +1,45 @@
+#ifndef SAMPLEPLUGIN_H
+#define SAMPLEPLUGIN_H
+
+#include <QObject>
+#include <QPointer>
+#include "modules/ModulePluginInterface.h"
+
+class QLabel;
+
+/**
+ * @brief 示例插件模块
+ *
+ * 演示插件模块的写法：与内置模块相同，只是不加入ModuleRegistry，而是由插件创建。
+ */
+class SampleModule : public ModuleBase {
+    Q_OBJECT
+
+public:
+    static ModuleType staticModuleType() { return ModuleType(UserDefined + 1); }   // 与SamplePlugin.json一致
+
+    explicit SampleModule(QWidget *parent = nullptr);
+
+    void clear() override;
+
+protected:
+    QWidget* buildContent() override;
+
+private:
+    QPointer<QLabel> m_counterLabel;   // 属于内容控件，休眠后为空
+    int m_clicks;
+};
+
+/**
+ * @brief 示例插件：提供SampleModule
+ */
+class SamplePlugin : public QObject, public ModulePluginInterface {
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID ModulePluginInterface_iid)
+    Q_INTERFACES(ModulePluginInterface)
+
+public:
+    ModuleBase* createModule(ModuleBase::ModuleType type) override;
+};
+
+#endif // SAMPLEPLUGIN_H
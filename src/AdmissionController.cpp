@@ -0,0 +1,172 @@
+#include "AdmissionController.h"
+
+AdmissionController::AdmissionController()
+    : m_globalCost{0.0, 0.0, 0}
+{
+    for (int i = 0; i < RESOURCE_COUNT; ++i) {
+        m_levels[i] = Normal;
+    }
+}
+
+void AdmissionController::recordCreation(int moduleType, const Usage& before, qint64 timestampMs) {
+    m_pending.append(PendingCreation{moduleType, before, timestampMs});
+}
+
+void AdmissionController::blend(Cost* cost, double cpuPercent, double rssMB) {
+    if (cost->samples == 0) {
+        cost->cpuPercent = cpuPercent;
+        cost->rssMB = rssMB;
+    } else {
+        cost->cpuPercent += EWMA_ALPHA * (cpuPercent - cost->cpuPercent);
+        cost->rssMB += EWMA_ALPHA * (rssMB - cost->rssMB);
+    }
+    ++cost->samples;
+}
+
+void AdmissionController::observe(const Usage& now, qint64 timestampMs) {
+    // 找出已经稳定的创建记录（按时间顺序追加，前面的先稳定）
+    int ready = 0;
+    while (ready < m_pending.size() && timestampMs - m_pending.at(ready).timestampMs >= SETTLE_MS) {
+        ++ready;
+    }
+    if (ready == 0) {
+        return;
+    }
+
+    // 同一时间段内的多次创建平分总增量；其它活动导致的负增量按0处理
+    const Usage& before = m_pending.first().before;
+    const double rssShare = qMax(0.0, now.processMemoryMB - before.processMemoryMB) / ready;
+    const double cpuShare = qMax(0.0, now.cpuPercent - before.cpuPercent) / ready;
+
+    for (int i = 0; i < ready; ++i) {
+        Cost& cost = m_costs[m_pending.at(i).moduleType];
+        blend(&cost, cpuShare, rssShare);
+        blend(&m_globalCost, cpuShare, rssShare);
+    }
+    m_pending.erase(m_pending.begin(), m_pending.begin() + ready);
+}
+
+AdmissionController::Cost AdmissionController::costOf(int moduleType) const {
+    // 表中的类型至少结算过一次；未知类型（包括-1）使用全局平均
+    return m_costs.value(moduleType, m_globalCost);
+}
+
+double AdmissionController::valueOf(const Usage& usage, Resource resource) {
+    switch (resource) {
+        case Cpu:
+            return usage.cpuPercent;
+        case SystemMemory:
+            return usage.memoryPercent;
+        case ProcessMemory:
+            return usage.processMemoryMB;
+        case RESOURCE_COUNT:
+            break;
+    }
+    return 0.0;
+}
+
+double AdmissionController::limitOf(const Limits& limits, Resource resource) {
+    switch (resource) {
+        case Cpu:
+            return limits.cpuPercent;
+        case SystemMemory:
+            return limits.memoryPercent;
+        case ProcessMemory:
+            return limits.processMemoryMB;
+        case RESOURCE_COUNT:
+            break;
+    }
+    return 0.0;
+}
+
+AdmissionController::Prediction AdmissionController::predict(int moduleType, const Usage& now,
+                                                             const Limits& limits, int count) const {
+    const Cost cost = costOf(moduleType);
+
+    // 尚未确认的创建也计入，避免连续快速创建时都基于同一份旧样本
+    const double modules = m_pending.size() + qMax(1, count);
+    const double memoryPercentPerModule =
+        now.memoryTotalMB > 0.0 ? cost.rssMB / now.memoryTotalMB * 100.0 : 0.0;
+
+    const double increments[RESOURCE_COUNT] = {
+        cost.cpuPercent * modules,
+        memoryPercentPerModule * modules,
+        cost.rssMB * modules
+    };
+
+    for (int i = 0; i < RESOURCE_COUNT; ++i) {
+        const Resource resource = Resource(i);
+        const double current = valueOf(now, resource);
+        const double limit = limitOf(limits, resource);
+        const double predicted = current + increments[i];
+        if (predicted > limit) {
+            return Prediction{false, resource, current, predicted, limit};
+        }
+    }
+
+    return Prediction{true, RESOURCE_COUNT, 0.0, 0.0, 0.0};
+}
+
+int AdmissionController::updatePressure(const Usage& now, const Limits& limits,
+                                        Transition* out, int capacity) {
+    int count = 0;
+
+    for (int i = 0; i < RESOURCE_COUNT; ++i) {
+        const Resource resource = Resource(i);
+        const double value = valueOf(now, resource);
+        const double limit = limitOf(limits, resource);
+        if (limit <= 0.0) {
+            continue;
+        }
+        const double ratio = value / limit;
+
+        const Level from = m_levels[i];
+        Level to = from;
+        switch (from) {
+            case Normal:
+                if (ratio > CRITICAL_ENTER) {
+                    to = Critical;
+                } else if (ratio > WARNING_ENTER) {
+                    to = Warning;
+                }
+                break;
+            case Warning:
+                if (ratio > CRITICAL_ENTER) {
+                    to = Critical;
+                } else if (ratio < WARNING_EXIT) {
+                    to = Normal;
+                }
+                break;
+            case Critical:
+                if (ratio < WARNING_EXIT) {
+                    to = Normal;
+                } else if (ratio < CRITICAL_EXIT) {
+                    to = Warning;
+                }
+                break;
+        }
+
+        if (to != from) {
+            m_levels[i] = to;
+            if (count < capacity) {
+                out[count++] = Transition{resource, from, to, value, limit};
+            }
+        }
+    }
+
+    return count;
+}
+
+const char* AdmissionController::resourceName(Resource resource) {
+    switch (resource) {
+        case Cpu:
+            return "CPU usage";
+        case SystemMemory:
+            return "Memory usage";
+        case ProcessMemory:
+            return "Process memory";
+        case RESOURCE_COUNT:
+            break;
+    }
+    return "Unknown";
+}
@@ -0,0 +1,44 @@
+#include "BoardVirtualizer.h"
+
+BoardVirtualizer::BoardVirtualizer(int margin, int materializePerFrame)
+    : m_margin(qMax(0, margin))
+    , m_materializePerFrame(qMax(1, materializePerFrame))
+{
+}
+
+QRect BoardVirtualizer::liveRect(const QRect& viewport) const {
+    return viewport.adjusted(-m_margin, -m_margin, m_margin, m_margin);
+}
+
+BoardVirtualizer::Changes BoardVirtualizer::update(const SpatialIndex& index, const QRect& viewport) {
+    const QList<int> visible = index.intersecting(liveRect(viewport));
+    QSet<int> live(visible.begin(), visible.end());
+
+    Changes changes;
+    for (int key : std::as_const(m_live)) {
+        if (!live.contains(key)) {
+            changes.left.append(key);
+        }
+    }
+    for (int key : std::as_const(live)) {
+        if (!m_live.contains(key)) {
+            changes.entered.append(key);
+        }
+    }
+    m_live.swap(live);
+    return changes;
+}
+
+void BoardVirtualizer::queueMaterialize(int key) {
+    m_pendingMaterialize.append(key);
+}
+
+void BoardVirtualizer::remove(int key) {
+    m_live.remove(key);
+    m_pendingMaterialize.removeAll(key);
+}
+
+void BoardVirtualizer::clear() {
+    m_live.clear();
+    m_pendingMaterialize.clear();
+}
@@ -0,0 +1,201 @@
+#include "EventLoopMonitor.h"
+#include <QThread>
+#include <QDebug>
+
+std::atomic<EventLoopMonitor*> EventLoopMonitor::s_instance(nullptr);
+
+EventLoopMonitor::EventLoopMonitor(QObject *parent)
+    : QObject(parent)
+    , m_guiThread(QThread::currentThreadId())
+    , m_depth(0)
+    , m_eventStartNs(0)
+    , m_eventType(QEvent::None)
+    , m_receiverMeta(nullptr)
+    , m_lastProbeNs(-1)
+    , m_lastActivityNs(0)
+    , m_recentFrameHead(0)
+    , m_recentFrameCount(0)
+    , m_recentStallHead(0)
+    , m_stallCount(0)
+    , m_stallBudgetUs(50 * 1000)   // 单个事件超过50ms视为卡顿
+    , m_frameBudgetUs(16 * 1000)   // 约60 FPS
+    , m_janky(false)
+{
+    m_clock.start();
+
+    for (int i = 0; i < RECENT_FRAMES; ++i) {
+        m_recentFrameUs[i] = 0;
+    }
+    for (int i = 0; i < RECENT_STALLS; ++i) {
+        m_recentStallNs[i] = -JANK_WINDOW_NS;
+    }
+
+    // 帧探测定时器：只在有用户交互时运行，空闲时不唤醒CPU
+    m_frameProbe = new QTimer(this);
+    m_frameProbe->setTimerType(Qt::PreciseTimer);
+    m_frameProbe->setInterval(16);
+    connect(m_frameProbe, &QTimer::timeout, this, &EventLoopMonitor::onFrameProbe);
+
+    EventLoopMonitor* expected = nullptr;
+    s_instance.compare_exchange_strong(expected, this, std::memory_order_acq_rel, std::memory_order_acquire);
+
+    qDebug() << "[EventLoopMonitor] Initialized with stall budget:" << stallBudgetMs() << "ms";
+}
+
+EventLoopMonitor::~EventLoopMonitor() {
+    EventLoopMonitor* expected = this;
+    s_instance.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel, std::memory_order_acquire);
+    qDebug() << "[EventLoopMonitor] Destroyed";
+}
+
+EventLoopMonitor* EventLoopMonitor::instance() {
+    return s_instance.load(std::memory_order_acquire);
+}
+
+bool EventLoopMonitor::isActivityEvent(QEvent::Type type) {
+    switch (type) {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseMove:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::NonClientAreaMouseButtonPress:
+        case QEvent::NonClientAreaMouseMove:
+        case QEvent::KeyPress:
+        case QEvent::Wheel:
+        case QEvent::Move:
+        case QEvent::Resize:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool EventLoopMonitor::beginEvent(QObject* receiver, QEvent* event) {
+    // 只统计GUI线程的最外层事件，嵌套事件的耗时已经包含在外层中
+    if (QThread::currentThreadId() != m_guiThread) {
+        return false;
+    }
+    if (m_depth++ > 0) {
+        return false;
+    }
+
+    m_eventStartNs = m_clock.nsecsElapsed();
+    m_eventType = event ? event->type() : QEvent::None;
+    m_receiverMeta = receiver ? receiver->metaObject() : nullptr;
+
+    // 有用户交互时启动帧探测
+    if (isActivityEvent(m_eventType)) {
+        m_lastActivityNs = m_eventStartNs;
+        if (!m_frameProbe->isActive()) {
+            m_lastProbeNs = -1;
+            m_frameProbe->start();
+        }
+    }
+    return true;
+}
+
+void EventLoopMonitor::endEvent() {
+    if (m_depth <= 0) {
+        return;
+    }
+    if (--m_depth > 0) {
+        return;
+    }
+
+    const qint64 nowNs = m_clock.nsecsElapsed();
+    const qint64 durationUs = (nowNs - m_eventStartNs) / 1000;
+    m_eventDurations.record(quint64(qMax<qint64>(0, durationUs)));
+
+    if (durationUs > m_stallBudgetUs.load()) {
+        m_stallCount.fetch_add(1);
+        m_recentStallNs[m_recentStallHead] = nowNs;
+        m_recentStallHead = (m_recentStallHead + 1) % RECENT_STALLS;
+        updateJankState(nowNs);
+
+        // 卡顿后保持探测，直到卡顿窗口过去
+        if (!m_frameProbe->isActive()) {
+            m_lastProbeNs = -1;
+            m_frameProbe->start();
+        }
+
+        const QString receiverClass = m_receiverMeta ? QString::fromLatin1(m_receiverMeta->className())
+                                                     : QString("<null>");
+        emit stallDetected(m_eventType, receiverClass, durationUs / 1000.0);
+    }
+}
+
+void EventLoopMonitor::onFrameProbe() {
+    const qint64 nowNs = m_clock.nsecsElapsed();
+
+    if (m_lastProbeNs >= 0) {
+        const qint64 intervalUs = (nowNs - m_lastProbeNs) / 1000;
+        m_frameIntervals.record(quint64(qMax<qint64>(0, intervalUs)));
+
+        m_recentFrameUs[m_recentFrameHead] = intervalUs;
+        m_recentFrameHead = (m_recentFrameHead + 1) % RECENT_FRAMES;
+        if (m_recentFrameCount < RECENT_FRAMES) {
+            ++m_recentFrameCount;
+        }
+    }
+    m_lastProbeNs = nowNs;
+
+    updateJankState(nowNs);
+
+    // 空闲且不再卡顿时停止探测，丢弃旧的帧间隔
+    if (nowNs - m_lastActivityNs > IDLE_STOP_NS && !m_janky.load()) {
+        m_frameProbe->stop();
+        m_recentFrameCount = 0;
+        m_recentFrameHead = 0;
+    }
+}
+
+void EventLoopMonitor::updateJankState(qint64 nowNs) {
+    // 最近窗口内发生过卡顿
+    bool janky = false;
+    for (int i = 0; i < RECENT_STALLS; ++i) {
+        if (nowNs - m_recentStallNs[i] < JANK_WINDOW_NS) {
+            janky = true;
+            break;
+        }
+    }
+
+    // 或者超过10%的最近帧间隔超出两倍帧预算
+    if (!janky && m_recentFrameCount >= 10) {
+        const qint64 slowThresholdUs = m_frameBudgetUs.load() * 2;
+        int slowFrames = 0;
+        for (int i = 0; i < m_recentFrameCount; ++i) {
+            if (m_recentFrameUs[i] > slowThresholdUs) {
+                ++slowFrames;
+            }
+        }
+        janky = slowFrames * 10 > m_recentFrameCount;
+    }
+
+    if (janky != m_janky.load()) {
+        m_janky.store(janky);
+        qDebug() << "[EventLoopMonitor] UI" << (janky ? "became janky" : "recovered");
+    }
+}
+
+EventLoopMonitor::Stats EventLoopMonitor::statsOf(const LatencyHistogram& histogram) {
+    Stats stats;
+    stats.count = histogram.count();
+    stats.p50Ms = histogram.percentileMicros(50.0) / 1000.0;
+    stats.p99Ms = histogram.percentileMicros(99.0) / 1000.0;
+    stats.maxMs = histogram.maxMicros() / 1000.0;
+    return stats;
+}
+
+EventLoopMonitor::Stats EventLoopMonitor::frameIntervalStats() const {
+    return statsOf(m_frameIntervals);
+}
+
+EventLoopMonitor::Stats EventLoopMonitor::eventDurationStats() const {
+    return statsOf(m_eventDurations);
+}
+
+void EventLoopMonitor::reset() {
+    m_frameIntervals.reset();
+    m_eventDurations.reset();
+    m_stallCount.store(0);
+}
@@ -0,0 +1,83 @@
+#include "LatencyHistogram.h"
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram()
+    : m_count(0)
+    , m_sum(0)
+    , m_max(0)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+int LatencyHistogram::bucketFor(quint64 micros) {
+    // 0~3微秒各自一个桶
+    if (micros < SUB_BUCKETS) {
+        return int(micros);
+    }
+
+    // exponent = floor(log2(micros))，mantissa取最高位之后的两位
+    int exponent = 0;
+    for (quint64 v = micros; v > 1; v >>= 1) {
+        ++exponent;
+    }
+    const int mantissa = int((micros >> (exponent - 2)) & (SUB_BUCKETS - 1));
+    const int index = SUB_BUCKETS + (exponent - 2) * SUB_BUCKETS + mantissa;
+    return qMin(index, BUCKET_COUNT - 1);
+}
+
+quint64 LatencyHistogram::bucketUpperBound(int index) {
+    if (index < SUB_BUCKETS) {
+        return quint64(qMax(index, 0));
+    }
+    const int exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + 2;
+    const int mantissa = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return (quint64(SUB_BUCKETS + mantissa + 1) << (exponent - 2)) - 1;
+}
+
+void LatencyHistogram::record(quint64 micros) {
+    m_buckets[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(micros, std::memory_order_relaxed);
+
+    quint64 currentMax = m_max.load(std::memory_order_relaxed);
+    while (micros > currentMax &&
+           !m_max.compare_exchange_weak(currentMax, micros, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+quint64 LatencyHistogram::bucketCount(int index) const {
+    if (index < 0 || index >= BUCKET_COUNT) {
+        return 0;
+    }
+    return m_buckets[index].load(std::memory_order_relaxed);
+}
+
+quint64 LatencyHistogram::percentileMicros(double percentile) const {
+    const quint64 total = count();
+    if (total == 0) {
+        return 0;
+    }
+
+    const double clamped = qBound(0.0, percentile, 100.0);
+    const quint64 rank = qMax<quint64>(1, quint64(std::ceil(clamped / 100.0 * double(total))));
+
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += bucketCount(i);
+        if (seen >= rank) {
+            return qMin(bucketUpperBound(i), maxMicros());
+        }
+    }
+    return maxMicros();
+}
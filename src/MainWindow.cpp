@@ -9,6 +9,9 @@
 #include <QResizeEvent>
 #include <QMoveEvent>
 #include <QScrollArea>
+#include <QScrollBar>
+#include <QDir>
+#include "Trace.h"
 
 // DraggableBoardWidget 实现
 DraggableBoardWidget::DraggableBoardWidget(QWidget *parent)
@@ -70,26 +73,41 @@ void DraggableBoardWidget::mouseReleaseEvent(QMouseEvent *event) {
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_moduleManager(new ModuleManager(this))
+    , m_nextSlotId(0)
+    , m_dropPreview(nullptr)
 {
+    // 几何同步：只在有变化时启动，空闲时不唤醒CPU
+    m_geometrySyncTimer = new QTimer(this);
+    m_geometrySyncTimer->setSingleShot(true);
+    m_geometrySyncTimer->setTimerType(Qt::PreciseTimer);
+    m_geometrySyncTimer->setInterval(GEOMETRY_SYNC_INTERVAL_MS);
+    connect(m_geometrySyncTimer, &QTimer::timeout, this, &MainWindow::syncGeometry);
+
     setupUI();
     setupMenuBar();
 
     // 连接模块管理器信号
-    connect(m_moduleManager, &ModuleManager::moduleCreated,
-            this, &MainWindow::onModuleCreated);
-    connect(m_moduleManager, &ModuleManager::moduleDestroyed,
-            this, &MainWindow::onModuleDestroyed);
-
-    // 创建定时器以持续更新吸附模块位置
-    m_updateTimer = new QTimer(this);
-    m_updateTimer->setInterval(16);  // 约60 FPS
-    connect(m_updateTimer, &QTimer::timeout, this, &MainWindow::updateAttachedModulesPosition);
-    m_updateTimer->start();
+    connect(m_moduleManager, &ModuleManager::modulesCreated,
+            this, &MainWindow::onModulesCreated);
+    connect(m_moduleManager, &ModuleManager::modulesDestroyed,
+            this, &MainWindow::onModulesDestroyed);
+    // 无界面创建的模块附加视图后，和新建的模块一样布局和显示
+    connect(m_moduleManager, &ModuleManager::viewAttached, this, [this](ModuleHandle handle) {
+        onModulesCreated(QList<ModuleHandle>{handle});
+    });
 
-    qDebug() << "[MainWindow] Initialized with draggable board and update timer";
+    qDebug() << "[MainWindow] Initialized with draggable board";
 }
 
 MainWindow::~MainWindow() {
+    // 嵌入的模块内容在白板的宿主控件中，白板先于模块销毁，先把内容移回各自的浮动框架
+    m_moduleManager->forEachModule([](ModuleBase* module) {
+        if (module->isEmbedded()) {
+            module->leaveBoard();
+        }
+    });
+    // 卡槽控件属于白板，这里只释放卡槽结构
+    qDeleteAll(m_slots);
     qDebug() << "[MainWindow] Destroyed";
 }
 
@@ -106,6 +124,7 @@ void MainWindow::setupUI() {
     centralLayout->setContentsMargins(0, 0, 0, 0);
 
     QScrollArea* scrollArea = new QScrollArea();
+    m_scrollArea = scrollArea;
     scrollArea->setWidgetResizable(false);  // 不自动调整大小
     scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     scrollArea->setVerticalScrollBarPolicy(Qt::ScrollBarAsNeeded);
@@ -127,6 +146,10 @@ void MainWindow::setupUI() {
     scrollArea->setWidget(m_boardWidget);
     centralLayout->addWidget(scrollArea);
 
+    // 滚动改变白板的全局位置
+    connect(scrollArea->horizontalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::markGeometryDirty);
+    connect(scrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this, &MainWindow::markGeometryDirty);
+
     // 创建左上角通知标签
     m_notificationLabel = new QLabel(this);
     m_notificationLabel->setStyleSheet(
@@ -159,87 +182,122 @@ void MainWindow::setupMenuBar() {
 
     QMenu* moduleMenu = menuBar->addMenu("Modules");
 
-    QAction* createExampleAction = moduleMenu->addAction("Create Example Module");
-    connect(createExampleAction, &QAction::triggered, this, &MainWindow::onCreateExampleModule);
+    // 每个注册的模块类型一个创建菜单项
+    ModuleRegistry::forEachType([this, moduleMenu](auto tag) {
+        using Module = typename decltype(tag)::Type;
+        QAction* createAction = moduleMenu->addAction(Module::staticMenuText());
+        connect(createAction, &QAction::triggered, this, [this]() {
+            createModuleFromMenu<Module>();
+        });
+    });
+
+    // 插件提供的模块类型：菜单项来自插件清单，不加载插件库
+    for (const ModulePluginLoader::TypeInfo& info : m_moduleManager->pluginLoader()->types()) {
+        QAction* createAction = moduleMenu->addAction(info.menuText);
+        const ModuleBase::ModuleType type = info.type;
+        connect(createAction, &QAction::triggered, this, [this, type]() {
+            createPluginModuleFromMenu(type);
+        });
+    }
+
+    moduleMenu->addSeparator();
+
+    // 一次批量销毁，界面只更新一次
+    QAction* closeAllAction = moduleMenu->addAction("Close All Modules");
+    connect(closeAllAction, &QAction::triggered, m_moduleManager, &ModuleManager::destroyAllModules);
+
+    moduleMenu->addSeparator();
 
-    QAction* createCustomAction = moduleMenu->addAction("Create Custom Module");
-    connect(createCustomAction, &QAction::triggered, this, &MainWindow::onCreateCustomModule);
+#ifdef MODULESYSTEM_TRACING
+    // 追踪：导出Chrome/Perfetto格式的事件记录
+    QAction* dumpTraceAction = moduleMenu->addAction("Dump Trace");
+    connect(dumpTraceAction, &QAction::triggered, this, [this]() {
+        const QString path = QDir(QDir::tempPath()).filePath(
+            QString("modulesystem-trace-%1.json").arg(QCoreApplication::applicationPid()));
+        if (Trace::dumpToFile(path)) {
+            QMessageBox::information(this, "Trace", QString("追踪数据已写入:\n%1").arg(path));
+        }
+    });
 
     moduleMenu->addSeparator();
+#endif
 
     QAction* exitAction = moduleMenu->addAction("Exit");
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
 }
 
-void MainWindow::onCreateExampleModule() {
+template<typename T>
+void MainWindow::createModuleFromMenu() {
+    // 模型在后台加载，窗口先显示占位控件，菜单操作不会阻塞界面
     QString performanceReason;
-    ExampleModule* module = m_moduleManager->createExampleModule(&performanceReason);
+    const QFuture<ModuleHandle> future = m_moduleManager->createModuleAsync<T>(&performanceReason);
 
-    if (!module) {
+    if (future.isCanceled()) {
         QMessageBox::warning(this, "性能限制",
             QString("无法创建新模块\n\n%1").arg(performanceReason));
         return;
     }
 
-    qDebug() << "[MainWindow] Example module created";
+    qDebug() << "[MainWindow]" << ModuleBase::moduleTypeName(T::staticModuleType()) << "module created";
 }
 
-void MainWindow::onCreateCustomModule() {
-    QString performanceReason;
-    CustomModuleTemplate* module = m_moduleManager->createCustomModule(&performanceReason);
+void MainWindow::createPluginModuleFromMenu(ModuleBase::ModuleType type) {
+    QString reason;
+    const QFuture<ModuleHandle> future = m_moduleManager->createPluginModuleAsync(type, &reason);
 
-    if (!module) {
-        QMessageBox::warning(this, "性能限制",
-            QString("无法创建新模块\n\n%1").arg(performanceReason));
+    if (future.isCanceled()) {
+        QMessageBox::warning(this, "无法创建模块",
+            QString("无法创建新模块\n\n%1").arg(reason));
         return;
     }
 
-    qDebug() << "[MainWindow] Custom module created";
+    qDebug() << "[MainWindow]" << m_moduleManager->pluginLoader()->typeName(type) << "plugin module created";
 }
 
-void MainWindow::onModuleCreated(ModuleBase* module) {
-    qDebug() << "[MainWindow] Module created:" << module->moduleTitle();
-
-    // 连接模块信号
-    connect(module, &ModuleBase::detachRequested, this, &MainWindow::onModuleDetachRequested);
-    connect(module, &ModuleBase::reattachRequested, this, &MainWindow::onModuleReattachRequested);
-    connect(module, &ModuleBase::closeRequested, this, &MainWindow::onModuleCloseRequested);
-    connect(module, &ModuleBase::dragPositionChanged, this, &MainWindow::onModuleDragPositionChanged);
+void MainWindow::onModulesCreated(const QList<ModuleHandle>& handles) {
+    MS_TRACE_SCOPE("MainWindow::onModulesCreated");
+    qDebug() << "[MainWindow] Modules created:" << handles.size();
 
-    // 添加到模块列表
-    m_allModules.append(module);
-
-    // 创建时不自动吸附，让用户手动拖拽
-    module->show();
-
-    // 设置初始位置在白板中心附近
+    // 整批只计算一次白板位置；按现有模块数量错开位置
     updateBoardGlobalRect();
-    int offsetX = (m_allModules.size() - 1) * 30;
-    int offsetY = (m_allModules.size() - 1) * 30;
-    module->move(m_boardGlobalRect.x() + 50 + offsetX,
-                 m_boardGlobalRect.y() + 50 + offsetY);
-
-    qDebug() << "[MainWindow] Module positioned at:" << module->pos();
+    int position = m_moduleManager->totalModuleCount() - handles.size();
+
+    for (ModuleHandle handle : handles) {
+        ModuleBase* module = m_moduleManager->module(handle);
+        if (!module) continue;
+
+        // 连接模块信号（从实例池复用的模块已经连接过）
+        connect(module, &ModuleBase::detachRequested, this, &MainWindow::onModuleDetachRequested,
+                Qt::UniqueConnection);
+        connect(module, &ModuleBase::reattachRequested, this, &MainWindow::onModuleReattachRequested,
+                Qt::UniqueConnection);
+        connect(module, &ModuleBase::closeRequested, this, &MainWindow::onModuleCloseRequested,
+                Qt::UniqueConnection);
+        connect(module, &ModuleBase::dragPositionChanged, this, &MainWindow::onModuleDragPositionChanged,
+                Qt::UniqueConnection);
+
+        // 先定位再显示，窗口只在最终位置绘制一次；创建时不自动吸附，让用户手动拖拽
+        const int offset = position++ * 30;
+        module->move(m_boardGlobalRect.x() + 50 + offset,
+                     m_boardGlobalRect.y() + 50 + offset);
+        module->show();
+    }
 }
 
-void MainWindow::onModuleDestroyed(ModuleBase* module) {
-    qDebug() << "[MainWindow] Module destroyed:" << module->moduleTitle();
-    m_allModules.removeAll(module);
+void MainWindow::onModulesDestroyed(const QList<ModuleHandle>& handles) {
+    MS_TRACE_SCOPE("MainWindow::onModulesDestroyed");
+    qDebug() << "[MainWindow] Modules destroyed:" << handles.size();
+
+    // 句柄已失效，卡槽不会再解析到这些模块；这里只回收卡槽
+    removeSlotsOf(handles);
 }
 
 void MainWindow::onModuleDetachRequested(ModuleBase* module) {
+    MS_TRACE_SCOPE_ID("MainWindow::onModuleDetachRequested", module->moduleId());
     qDebug() << "[MainWindow] Detach requested for:" << module->moduleTitle();
 
-    // 找到并移除关联的卡槽
-    for (auto it = m_slots.begin(); it != m_slots.end(); ) {
-        Slot* slot = *it;
-        if (slot->module == module) {
-            removeSlot(slot);
-            it = m_slots.erase(it);
-        } else {
-            ++it;
-        }
-    }
+    // 按模块找到并移除关联的卡槽（不扫描卡槽列表）
+    removeSlotsOf(module->moduleHandle());
 
     module->detachFromSlot();
 
@@ -248,55 +306,50 @@ void MainWindow::onModuleDetachRequested(ModuleBase* module) {
 }
 
 void MainWindow::onModuleReattachRequested(ModuleBase* module) {
+    MS_TRACE_SCOPE_ID("MainWindow::onModuleReattachRequested", module->moduleId());
     qDebug() << "[MainWindow] Reattach requested for:" << module->moduleTitle();
 
     updateBoardGlobalRect();
+    showDropPreview(QRect());
 
-    // 检查模块是否完全在白板内
-    if (isModuleFullyInBoard(module)) {
-        // 获取模块当前的全局矩形
-        QRect moduleGlobalRect = module->frameGeometry();
-
-        // 创建临时卡槽在模块当前位置
-        Slot* slot = createTemporarySlot(moduleGlobalRect);
-
-        if (slot) {
-            // 将模块吸附到卡槽
-            slot->module = module;
-            slot->isOccupied = true;
-
-            // 计算卡槽的全局矩形
-            QRect slotGlobalRect = QRect(
-                m_boardWidget->mapToGlobal(slot->localRect.topLeft()),
-                slot->localRect.size()
-            );
-
-            // 使用旧的attachToSlot逻辑
-            module->attachToSlot(slotGlobalRect);
-
-            // 显示吸附成功通知
-            m_notificationLabel->setText("已吸附到白板");
-            m_notificationLabel->setStyleSheet(
-                "background-color: rgba(76, 175, 80, 0.9); "
-                "color: white; "
-                "padding: 8px 12px; "
-                "border-radius: 4px; "
-                "font-size: 13px;"
-            );
-            m_notificationLabel->adjustSize();
-            m_notificationLabel->show();
-            m_notificationLabel->raise();
-
-            // 2秒后自动隐藏通知
-            QTimer::singleShot(2000, this, [this]() {
-                m_notificationLabel->hide();
-            });
-
-            qDebug() << "[MainWindow] Module attached to slot at:" << slotGlobalRect;
-        }
+    // 完全在白板内且不与已吸附的模块重叠时，在当前位置（靠近其它卡槽时吸附对齐）创建卡槽
+    bool overlapping = false;
+    const QRect target = dropTargetFor(module, &overlapping);
+    if (!target.isNull()) {
+        Slot* slot = createTemporarySlot(target, module->moduleHandle());
+
+        // 嵌入白板：模块成为白板的子控件，平移和滚动时随白板一起移动
+        module->embedInto(m_boardWidget, slot->localRect);
+
+        // 显示吸附成功通知
+        m_notificationLabel->setText("已吸附到白板");
+        m_notificationLabel->setStyleSheet(
+            "background-color: rgba(76, 175, 80, 0.9); "
+            "color: white; "
+            "padding: 8px 12px; "
+            "border-radius: 4px; "
+            "font-size: 13px;"
+        );
+        m_notificationLabel->adjustSize();
+        m_notificationLabel->show();
+        m_notificationLabel->raise();
+
+        // 2秒后自动隐藏通知
+        QTimer::singleShot(2000, this, [this]() {
+            m_notificationLabel->hide();
+        });
+
+        qDebug() << "[MainWindow] Module embedded in slot at:" << slot->localRect;
+
+        // 新卡槽加入可见集合
+        markGeometryDirty();
     } else {
         m_notificationLabel->hide();
-        qDebug() << "[MainWindow] Module not fully in board, cannot attach";
+        if (overlapping) {
+            qDebug() << "[MainWindow] Module overlaps an attached module, cannot attach";
+        } else {
+            qDebug() << "[MainWindow] Module not fully in board, cannot attach";
+        }
     }
 }
 
@@ -308,25 +361,29 @@ void MainWindow::onModuleCloseRequested(ModuleBase* module) {
 }
 
 void MainWindow::onModuleDragPositionChanged(ModuleBase* module, const QPoint& globalPos) {
+    MS_TRACE_SCOPE_ID("MainWindow::onModuleDragPositionChanged", module->moduleId());
     if (globalPos.x() < 0 || globalPos.y() < 0) {
-        // 拖拽结束，隐藏通知
+        // 拖拽结束，隐藏通知和放入位置
         m_notificationLabel->hide();
+        showDropPreview(QRect());
         return;
     }
 
     updateBoardGlobalRect();
 
-    // 检查模块是否完全在白板内
-    if (isModuleFullyInBoard(module)) {
-        // 显示通知：可以吸附
-        m_notificationLabel->setText("可以放入白板");
-        m_notificationLabel->setStyleSheet(
-            "background-color: rgba(33, 150, 243, 0.9); "
+    // 高亮放入位置；与已吸附的模块重叠时提示
+    bool overlapping = false;
+    const QRect target = dropTargetFor(module, &overlapping);
+    showDropPreview(target);
+    if (!target.isNull() || overlapping) {
+        m_notificationLabel->setText(overlapping ? "与已吸附的模块重叠" : "可以放入白板");
+        m_notificationLabel->setStyleSheet(QString(
+            "background-color: %1; "
             "color: white; "
             "padding: 8px 12px; "
             "border-radius: 4px; "
             "font-size: 13px;"
-        );
+        ).arg(overlapping ? "rgba(255, 152, 0, 0.9)" : "rgba(33, 150, 243, 0.9)"));
         m_notificationLabel->adjustSize();
         m_notificationLabel->show();
         m_notificationLabel->raise();
@@ -354,6 +411,77 @@ bool MainWindow::isModuleFullyInBoard(ModuleBase* module) {
     return fullyInside;
 }
 
+QRect MainWindow::dropTargetFor(ModuleBase* module, bool* overlapping) {
+    if (overlapping) {
+        *overlapping = false;
+    }
+    if (!isModuleFullyInBoard(module)) {
+        return QRect();
+    }
+
+    const QRect globalRect = module->frameGeometry();
+    const QRect localRect(m_boardWidget->mapFromGlobal(globalRect.topLeft()), globalRect.size());
+
+    // 优先使用吸附对齐后的位置；对齐后越界或重叠时退回原位置
+    const QRect snapped = snapToNeighbors(localRect);
+    if (snapped != localRect && m_boardWidget->rect().contains(snapped) && !m_slotIndex.intersectsAny(snapped)) {
+        return snapped;
+    }
+    if (!m_slotIndex.intersectsAny(localRect)) {
+        return localRect;
+    }
+    if (overlapping) {
+        *overlapping = true;
+    }
+    return QRect();
+}
+
+QRect MainWindow::snapToNeighbors(const QRect& localRect) const {
+    const int neighborId = m_slotIndex.nearest(localRect, SLOT_SNAP_DISTANCE);
+    if (neighborId < 0) {
+        return localRect;
+    }
+    const QRect neighbor = m_slotIndex.rect(neighborId);
+    QRect snapped = localRect;
+
+    // 有间隙的方向贴到邻居的边上；另一个方向边缘接近时对齐
+    if (localRect.left() > neighbor.right()) {
+        snapped.moveLeft(neighbor.right() + 1);
+    } else if (localRect.right() < neighbor.left()) {
+        snapped.moveRight(neighbor.left() - 1);
+    } else if (qAbs(localRect.left() - neighbor.left()) <= SLOT_SNAP_DISTANCE) {
+        snapped.moveLeft(neighbor.left());
+    }
+    if (localRect.top() > neighbor.bottom()) {
+        snapped.moveTop(neighbor.bottom() + 1);
+    } else if (localRect.bottom() < neighbor.top()) {
+        snapped.moveBottom(neighbor.top() - 1);
+    } else if (qAbs(localRect.top() - neighbor.top()) <= SLOT_SNAP_DISTANCE) {
+        snapped.moveTop(neighbor.top());
+    }
+    return snapped;
+}
+
+void MainWindow::showDropPreview(const QRect& localRect) {
+    if (localRect.isNull()) {
+        if (m_dropPreview) {
+            m_dropPreview->hide();
+        }
+        return;
+    }
+    if (!m_dropPreview) {
+        m_dropPreview = new QWidget(m_boardWidget);
+        m_dropPreview->setAttribute(Qt::WA_TransparentForMouseEvents);
+        m_dropPreview->setStyleSheet(
+            "background-color: rgba(76, 175, 80, 0.15); "
+            "border: 2px dashed #4CAF50;"
+        );
+    }
+    m_dropPreview->setGeometry(localRect);
+    m_dropPreview->show();
+    m_dropPreview->raise();
+}
+
 QRect MainWindow::getBoardGlobalRect() const {
     return m_boardGlobalRect;
 }
@@ -368,44 +496,95 @@ void MainWindow::updateBoardGlobalRect() {
 void MainWindow::resizeEvent(QResizeEvent *event) {
     QMainWindow::resizeEvent(event);
     updateBoardGlobalRect();
+    markGeometryDirty();
 }
 
 void MainWindow::moveEvent(QMoveEvent *event) {
     QMainWindow::moveEvent(event);
     updateBoardGlobalRect();
+    markGeometryDirty();
 }
 
 void MainWindow::onBoardMoved(const QPoint& delta) {
-    qDebug() << "[MainWindow] Board moved by delta:" << delta;
+    Q_UNUSED(delta);
+    // 拖动白板时每个鼠标事件都会发出，合并到下一帧统一移动
+    markGeometryDirty();
+}
 
-    // 更新白板的全局矩形
+void MainWindow::markGeometryDirty() {
+    if (!m_geometrySyncTimer->isActive()) {
+        m_geometrySyncTimer->start();
+    }
+}
+
+void MainWindow::syncGeometry() {
+    MS_TRACE_SCOPE("MainWindow::syncGeometry");
+
+    // 白板上的模块都嵌入在白板中，随白板移动，不需要逐个同步；
+    // 每帧只更新白板的全局矩形和视口虚拟化，耗时与卡槽总数无关
     updateBoardGlobalRect();
+    updateVirtualization();
+}
 
-    // 更新所有卡槽中模块的位置
-    for (Slot* slot : m_slots) {
-        if (slot->isOccupied && slot->module) {
-            // 计算新的卡槽全局位置
-            QRect slotGlobalRect = QRect(
-                m_boardWidget->mapToGlobal(slot->localRect.topLeft()),
-                slot->localRect.size()
-            );
+QRect MainWindow::visibleBoardRect() const {
+    QWidget* viewport = m_scrollArea->viewport();
+    return QRect(m_boardWidget->mapFrom(viewport, QPoint(0, 0)), viewport->size());
+}
 
-            // 更新模块位置以匹配卡槽
-            slot->module->move(slotGlobalRect.topLeft());
+ModuleBase* MainWindow::slotModule(int slotId) const {
+    const Slot* slot = m_slots.value(slotId);
+    return slot ? m_moduleManager->module(slot->module) : nullptr;
+}
 
-            qDebug() << "[MainWindow] Updated module" << slot->module->moduleId()
-                     << "position to match slot:" << slotGlobalRect.topLeft();
+void MainWindow::updateVirtualization() {
+    MS_TRACE_SCOPE("MainWindow::updateVirtualization");
+
+    const BoardVirtualizer::Changes changes = m_virtualizer.update(m_slotIndex, visibleBoardRect());
+
+    // 离开视口的模块停放
+    int parked = 0;
+    for (int slotId : changes.left) {
+        ModuleBase* module = slotModule(slotId);
+        if (module && module->park()) {
+            ++parked;
+        }
+    }
+    // 内容控件已同步销毁；滚动停下后才释放一次堆内存
+    if (parked > 0) {
+        m_moduleManager->scheduleHeapTrim();
+    }
+
+    // 进入视口的模块立即显示（截图），停放时休眠的内容排队重建；
+    // 内存压力下被ModuleManager休眠的模块保持休眠，直到用户点击
+    for (int slotId : changes.entered) {
+        if (ModuleBase* module = slotModule(slotId)) {
+            module->unpark();
+            if (module->isHibernatedByPark()) {
+                m_virtualizer.queueMaterialize(slotId);
+            }
         }
     }
+
+    // 快速滚动时一帧内进入视口的模块可能很多，分摊到之后的帧中重建
+    const QList<int> batch = m_virtualizer.takeMaterializeBatch([this](int slotId) {
+        ModuleBase* module = slotModule(slotId);
+        return module && module->isHibernatedByPark() && !module->isParked();
+    });
+    for (int slotId : batch) {
+        slotModule(slotId)->wake();
+    }
+    if (m_virtualizer.hasPendingMaterialize()) {
+        markGeometryDirty();
+    }
 }
 
-MainWindow::Slot* MainWindow::createTemporarySlot(const QRect& moduleGlobalRect) {
-    // 将全局坐标转换为白板本地坐标
-    QPoint localTopLeft = m_boardWidget->mapFromGlobal(moduleGlobalRect.topLeft());
+MainWindow::Slot* MainWindow::createTemporarySlot(const QRect& localRect, ModuleHandle module) {
+    // 一个模块只占用一个卡槽
+    removeSlotsOf(module);
 
     // 创建卡槽widget
     QWidget* slotWidget = new QWidget(m_boardWidget);
-    slotWidget->setGeometry(QRect(localTopLeft, moduleGlobalRect.size()));
+    slotWidget->setGeometry(localRect);
     slotWidget->setStyleSheet(
         "background-color: rgba(33, 150, 243, 0.2); "
         "border: 2px dashed #2196F3;"
@@ -414,19 +593,47 @@ MainWindow::Slot* MainWindow::createTemporarySlot(const QRect& moduleGlobalRect)
 
     // 创建卡槽结构
     Slot* slot = new Slot();
+    slot->id = m_nextSlotId++;
     slot->widget = slotWidget;
-    slot->localRect = QRect(localTopLeft, moduleGlobalRect.size());
-    slot->module = nullptr;
-    slot->isOccupied = false;
+    slot->localRect = localRect;
+    slot->module = module;
+    slot->isOccupied = true;
 
-    m_slots.append(slot);
+    m_slots.insert(slot->id, slot);
+    m_slotByModule.insert(module, slot->id);
+    m_slotIndex.insert(slot->id, localRect);
 
-    qDebug() << "[MainWindow] Created slot at local pos:" << localTopLeft
-             << "size:" << moduleGlobalRect.size();
+    qDebug() << "[MainWindow] Created slot at local pos:" << localRect.topLeft()
+             << "size:" << localRect.size();
 
     return slot;
 }
 
+void MainWindow::removeSlotsOf(ModuleHandle handle) {
+    removeSlotsOf(QList<ModuleHandle>{handle});
+}
+
+void MainWindow::removeSlotsOf(const QList<ModuleHandle>& handles) {
+    if (handles.isEmpty() || m_slotByModule.isEmpty()) {
+        return;
+    }
+
+    // 按模块直接找到卡槽；白板在整批删除后只重绘一次
+    m_boardWidget->setUpdatesEnabled(false);
+    for (ModuleHandle handle : handles) {
+        auto it = m_slotByModule.find(handle);
+        if (it == m_slotByModule.end()) {
+            continue;
+        }
+        const int id = it.value();
+        m_slotByModule.erase(it);
+        m_slotIndex.remove(id);
+        m_virtualizer.remove(id);
+        removeSlot(m_slots.take(id));
+    }
+    m_boardWidget->setUpdatesEnabled(true);
+}
+
 void MainWindow::removeSlot(Slot* slot) {
     if (!slot) return;
 
@@ -440,28 +647,3 @@ void MainWindow::removeSlot(Slot* slot) {
 
     delete slot;
 }
-
-void MainWindow::updateAttachedModulesPosition() {
-    // 遍历所有卡槽，更新吸附模块的位置
-    for (Slot* slot : m_slots) {
-        if (slot->isOccupied && slot->module) {
-            // 计算卡槽的当前全局位置
-            QRect slotGlobalRect = QRect(
-                m_boardWidget->mapToGlobal(slot->localRect.topLeft()),
-                slot->localRect.size()
-            );
-
-            // 获取模块当前位置
-            QPoint currentModulePos = slot->module->pos();
-            QPoint targetPos = slotGlobalRect.topLeft();
-
-            // 如果位置不匹配，更新模块位置
-            if (currentModulePos != targetPos) {
-                slot->module->move(targetPos);
-                // 只在位置变化时打印日志，避免刷屏
-                // qDebug() << "[MainWindow] Updated module" << slot->module->moduleId()
-                //          << "to slot position:" << targetPos;
-            }
-        }
-    }
-}
@@ -0,0 +1,154 @@
+#include "MetricsExporter.h"
+#include "EventLoopMonitor.h"
+#include "PerformanceMonitor.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QDebug>
+
+const char* const MetricsExporter::SOCKET_ENV_VAR = "MODULESYSTEM_METRICS_SOCKET";
+
+MetricsExporter::MetricsExporter(PerformanceMonitor* monitor, QObject *parent)
+    : QObject(parent)
+    , m_monitor(monitor)
+    , m_hibernatedModules(0)
+{
+    // 导出线程：服务端对象属于该线程，连接处理都在该线程中进行
+    m_thread = new QThread(this);
+    m_thread->setObjectName("MetricsExporter");
+
+    m_server = new QLocalServer();
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    m_server->moveToThread(m_thread);
+
+    connect(m_server, &QLocalServer::newConnection, m_server, [this]() {
+        while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+            handleConnection(socket);
+        }
+    });
+    connect(m_thread, &QThread::finished, m_server, &QObject::deleteLater);
+
+    m_thread->start(QThread::LowPriority);
+}
+
+MetricsExporter::~MetricsExporter() {
+    m_thread->quit();
+    m_thread->wait();
+    qDebug() << "[MetricsExporter] Destroyed";
+}
+
+bool MetricsExporter::listen(const QString& socketName) {
+    bool ok = false;
+    QString fullName;
+    QString error;
+
+    // QLocalServer必须在所属线程中操作，这里只在启动时阻塞一次
+    QMetaObject::invokeMethod(m_server, [&]() {
+        m_server->close();
+        QLocalServer::removeServer(socketName);   // 清理上次异常退出留下的套接字文件
+        ok = m_server->listen(socketName);
+        fullName = m_server->fullServerName();
+        error = m_server->errorString();
+    }, Qt::BlockingQueuedConnection);
+
+    if (!ok) {
+        qWarning() << "[MetricsExporter] Failed to listen on" << socketName << ":" << error;
+        return false;
+    }
+
+    m_fullServerName = fullName;
+    qDebug() << "[MetricsExporter] Serving metrics on" << m_fullServerName;
+    return true;
+}
+
+void MetricsExporter::setModuleCount(const QString& typeName, int count) {
+    QMetaObject::invokeMethod(m_server, [this, typeName, count]() {
+        m_moduleCounts[typeName] = count;
+    }, Qt::QueuedConnection);
+}
+
+void MetricsExporter::setHibernatedModuleCount(int count) {
+    QMetaObject::invokeMethod(m_server, [this, count]() {
+        m_hibernatedModules = count;
+    }, Qt::QueuedConnection);
+}
+
+void MetricsExporter::handleConnection(QLocalSocket* socket) {
+    connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+
+    // HTTP客户端会先发送请求头；原始客户端不发送任何数据，等待片刻后直接输出
+    QTimer* rawClientTimer = new QTimer(socket);
+    rawClientTimer->setSingleShot(true);
+    rawClientTimer->setInterval(RAW_CLIENT_WAIT_MS);
+    connect(rawClientTimer, &QTimer::timeout, socket, [this, socket]() {
+        respond(socket, QByteArray());
+    });
+
+    connect(socket, &QLocalSocket::readyRead, socket, [this, socket]() {
+        const QByteArray request = socket->peek(MAX_REQUEST_BYTES);
+        if (request.contains("\r\n\r\n") || request.contains("\n\n") ||
+            request.size() >= MAX_REQUEST_BYTES) {
+            respond(socket, request);
+        }
+    });
+
+    rawClientTimer->start();
+}
+
+void MetricsExporter::respond(QLocalSocket* socket, const QByteArray& request) {
+    // 每个连接只响应一次
+    disconnect(socket, &QLocalSocket::readyRead, socket, nullptr);
+    for (QTimer* timer : socket->findChildren<QTimer*>()) {
+        timer->stop();
+    }
+
+    if (request.isEmpty()) {
+        socket->write(renderMetrics());
+    } else if (request.startsWith("GET ")) {
+        const QByteArray body = renderMetrics();
+        socket->write("HTTP/1.0 200 OK\r\n"
+                      "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                      "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                      "Connection: close\r\n\r\n");
+        socket->write(body);
+    } else {
+        socket->write("HTTP/1.0 405 Method Not Allowed\r\n"
+                      "Content-Length: 0\r\n"
+                      "Connection: close\r\n\r\n");
+    }
+
+    // 数据写完后再断开
+    socket->disconnectFromServer();
+}
+
+QByteArray MetricsExporter::renderMetrics() const {
+    MetricsExposition::Snapshot snapshot = MetricsExposition::emptySnapshot();
+
+    // 性能指标：SeqLock快照，不阻塞采样线程
+    const PerformanceMonitor::PerformanceMetrics metrics = m_monitor->getCurrentMetrics();
+    snapshot.cpuUsagePercent = metrics.cpuUsagePercent;
+    snapshot.memoryUsedMB = metrics.memoryUsedMB;
+    snapshot.memoryTotalMB = metrics.memoryTotalMB;
+    snapshot.memoryUsagePercent = metrics.memoryUsagePercent;
+    snapshot.processMemoryMB = metrics.processMemoryMB;
+    snapshot.memoryLimitedByCgroup = metrics.memoryLimitedByCgroup;
+    snapshot.cpuLimitedByCgroup = metrics.cpuLimitedByCgroup;
+    snapshot.cpuLimitCores = metrics.cpuLimitCores;
+
+    // 事件循环：直方图计数都是原子变量
+    EventLoopMonitor* loop = EventLoopMonitor::instance();
+    if (loop) {
+        snapshot.hasEventLoop = true;
+        snapshot.eventDuration = MetricsExposition::histogramFrom(loop->eventDurationHistogram());
+        snapshot.frameInterval = MetricsExposition::histogramFrom(loop->frameIntervalHistogram());
+        snapshot.stallCount = loop->stallCount();
+        snapshot.uiJanky = loop->isUiJanky();
+    }
+
+    for (auto it = m_moduleCounts.constBegin(); it != m_moduleCounts.constEnd(); ++it) {
+        snapshot.moduleCounts.append(MetricsExposition::ModuleCount{it.key(), it.value()});
+    }
+    snapshot.hibernatedModules = m_hibernatedModules;
+
+    return MetricsExposition::render(snapshot);
+}
@@ -0,0 +1,151 @@
+#include "MetricsExposition.h"
+
+namespace MetricsExposition {
+
+const double LATENCY_BOUNDS_SECONDS[LATENCY_BOUND_COUNT] = {
+    0.001, 0.002, 0.004, 0.008, 0.016, 0.033, 0.05, 0.1, 0.25, 0.5, 1.0
+};
+
+namespace {
+
+QByteArray formatDouble(double value) {
+    return QByteArray::number(value, 'g', 10);
+}
+
+QByteArray escapeLabel(const QString& value) {
+    QByteArray escaped;
+    const QByteArray utf8 = value.toUtf8();
+    for (char c : utf8) {
+        if (c == '\\' || c == '"') {
+            escaped.append('\\');
+            escaped.append(c);
+        } else if (c == '\n') {
+            escaped.append("\\n");
+        } else {
+            escaped.append(c);
+        }
+    }
+    return escaped;
+}
+
+void appendHeader(QByteArray& out, const char* name, const char* type, const char* help) {
+    out.append("# HELP ").append(name).append(' ').append(help).append('\n');
+    out.append("# TYPE ").append(name).append(' ').append(type).append('\n');
+}
+
+void appendGauge(QByteArray& out, const char* name, const char* help, const QByteArray& value) {
+    appendHeader(out, name, "gauge", help);
+    out.append(name).append(' ').append(value).append('\n');
+}
+
+void appendHistogram(QByteArray& out, const char* name, const char* help, const Histogram& histogram) {
+    appendHeader(out, name, "histogram", help);
+    for (int i = 0; i < LATENCY_BOUND_COUNT; ++i) {
+        out.append(name).append("_bucket{le=\"").append(formatDouble(LATENCY_BOUNDS_SECONDS[i]))
+           .append("\"} ").append(QByteArray::number(histogram.cumulative[i])).append('\n');
+    }
+    out.append(name).append("_bucket{le=\"+Inf\"} ").append(QByteArray::number(histogram.count)).append('\n');
+    out.append(name).append("_sum ").append(formatDouble(histogram.sumSeconds)).append('\n');
+    out.append(name).append("_count ").append(QByteArray::number(histogram.count)).append('\n');
+}
+
+} // namespace
+
+Snapshot emptySnapshot() {
+    Snapshot snapshot;
+    snapshot.cpuUsagePercent = 0.0;
+    snapshot.memoryUsedMB = 0;
+    snapshot.memoryTotalMB = 0;
+    snapshot.memoryUsagePercent = 0.0;
+    snapshot.processMemoryMB = 0;
+    snapshot.memoryLimitedByCgroup = false;
+    snapshot.cpuLimitedByCgroup = false;
+    snapshot.cpuLimitCores = 0.0;
+    snapshot.hasEventLoop = false;
+    snapshot.eventDuration = Histogram{{0}, 0, 0.0};
+    snapshot.frameInterval = Histogram{{0}, 0, 0.0};
+    snapshot.stallCount = 0;
+    snapshot.uiJanky = false;
+    snapshot.hibernatedModules = 0;
+    return snapshot;
+}
+
+Histogram histogramFrom(const LatencyHistogram& histogram) {
+    Histogram result = Histogram{{0}, 0, 0.0};
+
+    // 桶的上界不超过导出边界时才计入，结果偏保守（约20%的分桶误差）
+    quint64 total = 0;
+    for (int bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; ++bucket) {
+        const quint64 count = histogram.bucketCount(bucket);
+        if (count == 0) {
+            continue;
+        }
+        total += count;
+        const double upperSeconds = LatencyHistogram::bucketUpperBound(bucket) / 1000000.0;
+        for (int i = 0; i < LATENCY_BOUND_COUNT; ++i) {
+            if (upperSeconds <= LATENCY_BOUNDS_SECONDS[i]) {
+                result.cumulative[i] += count;
+            }
+        }
+    }
+
+    // 用各桶之和作为总数，保证+Inf不小于任何一个边界（记录可能与读取并发）
+    result.count = total;
+    result.sumSeconds = histogram.sumMicros() / 1000000.0;
+    return result;
+}
+
+QByteArray render(const Snapshot& snapshot) {
+    QByteArray out;
+    out.reserve(4096);
+
+    appendGauge(out, "modulesystem_cpu_usage_percent",
+                "CPU usage in percent (relative to the cgroup cpu.max quota when limited)",
+                formatDouble(snapshot.cpuUsagePercent));
+    appendGauge(out, "modulesystem_memory_used_bytes",
+                "System or container memory in use",
+                QByteArray::number(snapshot.memoryUsedMB * 1024 * 1024));
+    appendGauge(out, "modulesystem_memory_total_bytes",
+                "System memory, or the cgroup memory.max limit when lower",
+                QByteArray::number(snapshot.memoryTotalMB * 1024 * 1024));
+    appendGauge(out, "modulesystem_memory_usage_percent",
+                "Memory usage in percent of modulesystem_memory_total_bytes",
+                formatDouble(snapshot.memoryUsagePercent));
+    appendGauge(out, "modulesystem_process_resident_bytes",
+                "Resident memory of the application process",
+                QByteArray::number(snapshot.processMemoryMB * 1024 * 1024));
+    appendGauge(out, "modulesystem_cgroup_memory_limited",
+                "1 when memory figures are relative to a cgroup limit",
+                snapshot.memoryLimitedByCgroup ? "1" : "0");
+    appendGauge(out, "modulesystem_cgroup_cpu_limit_cores",
+                "CPU quota from cgroup cpu.max in cores (0 when unlimited)",
+                formatDouble(snapshot.cpuLimitedByCgroup ? snapshot.cpuLimitCores : 0.0));
+
+    if (snapshot.hasEventLoop) {
+        appendHistogram(out, "modulesystem_event_duration_seconds",
+                        "Time spent dispatching top-level GUI events", snapshot.eventDuration);
+        appendHistogram(out, "modulesystem_frame_interval_seconds",
+                        "Interval between frame probes while the user interacts", snapshot.frameInterval);
+
+        appendHeader(out, "modulesystem_event_loop_stalls_total", "counter",
+                     "GUI events that exceeded the stall budget");
+        out.append("modulesystem_event_loop_stalls_total ").append(QByteArray::number(snapshot.stallCount)).append('\n');
+
+        appendGauge(out, "modulesystem_ui_janky",
+                    "1 while the event loop is considered janky",
+                    snapshot.uiJanky ? "1" : "0");
+    }
+
+    appendHeader(out, "modulesystem_modules", "gauge", "Open modules by type");
+    for (const ModuleCount& entry : snapshot.moduleCounts) {
+        out.append("modulesystem_modules{type=\"").append(escapeLabel(entry.typeName))
+           .append("\"} ").append(QByteArray::number(entry.count)).append('\n');
+    }
+    appendGauge(out, "modulesystem_modules_hibernated",
+                "Modules whose content is currently hibernated",
+                QByteArray::number(snapshot.hibernatedModules));
+
+    return out;
+}
+
+} // namespace MetricsExposition
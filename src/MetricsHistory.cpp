@@ -0,0 +1,78 @@
+#include "MetricsHistory.h"
+#include <algorithm>
+#include <cmath>
+
+MetricsHistory::MetricsHistory()
+    : m_head(0)
+    , m_count(0)
+{
+    for (int i = 0; i < CAPACITY; ++i) {
+        m_samples[i] = Sample{0.0, 0.0, 0.0};
+    }
+}
+
+void MetricsHistory::append(const Sample& sample) {
+    m_samples[m_head] = sample;
+    m_head = (m_head + 1) % CAPACITY;
+    if (m_count < CAPACITY) {
+        ++m_count;
+    }
+}
+
+void MetricsHistory::clear() {
+    m_head = 0;
+    m_count = 0;
+}
+
+MetricsHistory::Sample MetricsHistory::at(int ageIndex) const {
+    if (ageIndex < 0 || ageIndex >= m_count) {
+        return Sample{0.0, 0.0, 0.0};
+    }
+    int index = (m_head - 1 - ageIndex + CAPACITY) % CAPACITY;
+    return m_samples[index];
+}
+
+double MetricsHistory::value(const Sample& sample, Metric metric) {
+    switch (metric) {
+        case CpuUsage:
+            return sample.cpuUsagePercent;
+        case MemoryUsage:
+            return sample.memoryUsagePercent;
+        case ProcessMemory:
+            return sample.processMemoryMB;
+    }
+    return 0.0;
+}
+
+MetricsHistory::WindowStats MetricsHistory::stats(Metric metric, int windowSamples) const {
+    WindowStats result{0, 0.0, 0.0, 0.0, 0.0};
+
+    const int count = qBound(0, windowSamples, m_count);
+    if (count == 0) {
+        return result;
+    }
+
+    // 栈上的临时数组，用于计算百分位
+    double values[CAPACITY];
+    double sum = 0.0;
+    result.min = value(at(0), metric);
+    result.max = result.min;
+
+    for (int i = 0; i < count; ++i) {
+        const double v = value(at(i), metric);
+        values[i] = v;
+        sum += v;
+        result.min = qMin(result.min, v);
+        result.max = qMax(result.max, v);
+    }
+
+    result.count = count;
+    result.mean = sum / count;
+
+    // 最近秩法：第ceil(0.95 * n)小的值
+    const int rank = qMax(1, int(std::ceil(0.95 * count)));
+    std::nth_element(values, values + rank - 1, values + count);
+    result.p95 = values[rank - 1];
+
+    return result;
+}
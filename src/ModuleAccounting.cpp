@@ -0,0 +1,309 @@
+#include "ModuleAccounting.h"
+#include <QHash>
+#include <QMutex>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef Q_OS_UNIX
+#include <time.h>
+#endif
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+struct ModuleAccounting::Counters {
+    std::atomic<int> refs;
+    std::atomic<quint64> cpuTimeNs;
+    std::atomic<quint64> allocatedBytes;
+    std::atomic<quint64> allocationCount;
+    std::atomic<quint64> eventCount;
+};
+
+namespace {
+
+// 每个线程的当前模块；只使用常量初始化的类型，operator new中可以安全访问
+thread_local ModuleAccounting::Counters* t_current = nullptr;
+thread_local quint64 t_sliceStartNs = 0;
+thread_local ModuleAccounting::ConstructionScope* t_construction = nullptr;
+
+struct RegistryEntry {
+    QString title;
+    ModuleAccounting::Counters* counters;
+};
+
+struct Registry {
+    QMutex mutex;
+    QHash<int, RegistryEntry> entries;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+quint64 threadCpuTimeNs() {
+#ifdef Q_OS_UNIX
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return quint64(ts.tv_sec) * 1000000000ULL + quint64(ts.tv_nsec);
+    }
+#endif
+
+#ifdef Q_OS_WIN
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        auto FileTimeToUInt64 = [](const FILETIME& ft) -> quint64 {
+            return ((quint64)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+        };
+        // FILETIME单位为100纳秒
+        return (FileTimeToUInt64(kernelTime) + FileTimeToUInt64(userTime)) * 100;
+    }
+#endif
+
+    return 0;
+}
+
+} // namespace
+
+void ModuleAccounting::switchTo(Counters* counters) {
+    // 把上一段CPU时间计入切换前的模块
+    const quint64 now = threadCpuTimeNs();
+    if (t_current && now > t_sliceStartNs) {
+        t_current->cpuTimeNs.fetch_add(now - t_sliceStartNs, std::memory_order_relaxed);
+    }
+    t_current = counters;
+    t_sliceStartNs = now;
+}
+
+void ModuleAccounting::acquire(Counters* counters) {
+    counters->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ModuleAccounting::release(Counters* counters) {
+    if (counters->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete counters;
+    }
+}
+
+ModuleAccounting::Scope::Scope(Counters* counters)
+    : m_counters(nullptr)
+    , m_previous(t_current)
+{
+    // 同一模块内的嵌套事件不需要切换，也不读取时钟
+    if (!counters || counters == t_current) {
+        return;
+    }
+    m_counters = counters;
+    acquire(counters);
+    counters->eventCount.fetch_add(1, std::memory_order_relaxed);
+    switchTo(counters);
+}
+
+ModuleAccounting::Scope::~Scope() {
+    if (!m_counters) {
+        return;
+    }
+    switchTo(m_previous);
+    release(m_counters);
+}
+
+ModuleAccounting::ConstructionScope::ConstructionScope()
+    : m_counters(nullptr)
+    , m_previous(t_current)
+    , m_outer(t_construction)
+{
+    t_construction = this;
+}
+
+ModuleAccounting::ConstructionScope::~ConstructionScope() {
+    t_construction = m_outer;
+    if (!m_counters) {
+        return;
+    }
+    switchTo(m_previous);
+    release(m_counters);
+}
+
+ModuleAccounting::Counters* ModuleAccounting::registerModule(int moduleId, const QString& title) {
+    Counters* counters = new Counters;
+    counters->refs.store(1, std::memory_order_relaxed);   // 注册表持有的引用
+    counters->cpuTimeNs.store(0, std::memory_order_relaxed);
+    counters->allocatedBytes.store(0, std::memory_order_relaxed);
+    counters->allocationCount.store(0, std::memory_order_relaxed);
+    counters->eventCount.store(0, std::memory_order_relaxed);
+
+    {
+        Registry& r = registry();
+        QMutexLocker locker(&r.mutex);
+        r.entries.insert(moduleId, RegistryEntry{title, counters});
+    }
+
+    // 正在构造的模块：从这里开始的分配计入该模块
+    ConstructionScope* construction = t_construction;
+    if (construction && !construction->m_counters) {
+        construction->m_counters = counters;
+        acquire(counters);
+        switchTo(counters);
+    }
+    return counters;
+}
+
+void ModuleAccounting::unregisterModule(int moduleId) {
+    Counters* counters = nullptr;
+    {
+        Registry& r = registry();
+        QMutexLocker locker(&r.mutex);
+        auto it = r.entries.find(moduleId);
+        if (it == r.entries.end()) {
+            return;
+        }
+        counters = it->counters;
+        r.entries.erase(it);
+    }
+    release(counters);
+}
+
+ModuleAccounting::Usage ModuleAccounting::usageOf(const Counters* counters) {
+    Usage usage = Usage{0, 0, 0, 0};
+    if (!counters) {
+        return usage;
+    }
+
+    usage.cpuTimeUs = counters->cpuTimeNs.load(std::memory_order_relaxed) / 1000;
+    usage.allocatedBytes = counters->allocatedBytes.load(std::memory_order_relaxed);
+    usage.allocationCount = counters->allocationCount.load(std::memory_order_relaxed);
+    usage.eventCount = counters->eventCount.load(std::memory_order_relaxed);
+
+    // 当前线程正在执行该模块的代码：加上尚未结算的时间片
+    if (counters == t_current) {
+        const quint64 now = threadCpuTimeNs();
+        if (now > t_sliceStartNs) {
+            usage.cpuTimeUs += (now - t_sliceStartNs) / 1000;
+        }
+    }
+    return usage;
+}
+
+ModuleAccounting::Usage ModuleAccounting::usageOf(int moduleId) {
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    auto it = r.entries.find(moduleId);
+    return usageOf(it != r.entries.end() ? it->counters : nullptr);
+}
+
+QList<ModuleAccounting::ModuleUsage> ModuleAccounting::topModules(int count) {
+    QList<ModuleUsage> result;
+    {
+        Registry& r = registry();
+        QMutexLocker locker(&r.mutex);
+        result.reserve(r.entries.size());
+        for (auto it = r.entries.cbegin(); it != r.entries.cend(); ++it) {
+            result.append(ModuleUsage{it.key(), it->title, usageOf(it->counters)});
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const ModuleUsage& a, const ModuleUsage& b) {
+        if (a.usage.allocatedBytes != b.usage.allocatedBytes) {
+            return a.usage.allocatedBytes > b.usage.allocatedBytes;
+        }
+        return a.usage.cpuTimeUs > b.usage.cpuTimeUs;
+    });
+
+    if (count > 0 && result.size() > count) {
+        result.erase(result.begin() + count, result.end());
+    }
+    return result;
+}
+
+void ModuleAccounting::recordAllocation(quint64 bytes) {
+    Counters* counters = t_current;
+    if (counters) {
+        counters->allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+        counters->allocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 全局分配钩子：只在当前线程有模块标记时额外做两次原子加法
+// ---------------------------------------------------------------------------
+
+namespace {
+
+void* countedAlloc(std::size_t size) {
+    ModuleAccounting::recordAllocation(size);
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        void* p = std::malloc(size);
+        if (p) {
+            return p;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            return nullptr;
+        }
+        handler();
+    }
+}
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return countedAlloc(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,71 @@
+#include "ModuleApplication.h"
+#include "modules/ModuleBase.h"
+#include <QDebug>
+
+ModuleApplication::ModuleApplication(int &argc, char **argv)
+    : QApplication(argc, argv)
+    , m_eventLoopMonitor(nullptr)
+{
+    // 先置空再创建：监控器构造期间发送的事件也会经过notify
+    m_eventLoopMonitor = new EventLoopMonitor(this);
+
+    connect(m_eventLoopMonitor, &EventLoopMonitor::stallDetected, this,
+            [](QEvent::Type eventType, const QString& receiverClass, double durationMs) {
+        qWarning() << "[ModuleApplication] Event loop stall:" << durationMs << "ms"
+                   << "event:" << eventType << "receiver:" << receiverClass;
+    });
+}
+
+ModuleApplication::~ModuleApplication() {
+    // 先断开notify中的引用，再销毁监控器
+    EventLoopMonitor* monitor = m_eventLoopMonitor;
+    m_eventLoopMonitor = nullptr;
+    delete monitor;
+}
+
+ModuleBase* ModuleApplication::owningModule(QObject* receiver) {
+    for (QObject* object = receiver; object; object = object->parent()) {
+        if (ModuleBase* module = qobject_cast<ModuleBase*>(object)) {
+            return module;
+        }
+        // 嵌入白板时内容不在模块的对象树中
+        if (ModuleContainer* container = qobject_cast<ModuleContainer*>(object)) {
+            return container->module();
+        }
+    }
+    return nullptr;
+}
+
+bool ModuleApplication::isInteractionEvent(QEvent::Type type) {
+    switch (type) {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::NonClientAreaMouseButtonPress:
+        case QEvent::KeyPress:
+        case QEvent::Wheel:
+        case QEvent::FocusIn:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool ModuleApplication::notify(QObject *receiver, QEvent *event) {
+    EventLoopMonitor* monitor = m_eventLoopMonitor;
+    const bool timed = monitor && monitor->beginEvent(receiver, event);
+    ModuleBase* module = owningModule(receiver);
+    if (module && isInteractionEvent(event->type())) {
+        module->markInteraction();
+    }
+
+    bool result;
+    {
+        // 队列连接的槽函数以QMetaCallEvent的形式到达，同样会计入所属模块
+        ModuleAccounting::Scope accounting(module ? module->accountingCounters() : nullptr);
+        result = QApplication::notify(receiver, event);
+    }
+    if (timed) {
+        monitor->endEvent();
+    }
+    return result;
+}
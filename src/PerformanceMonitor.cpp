@@ -1,4 +1,5 @@
 #include "PerformanceMonitor.h"
+#include "ModuleAccounting.h"
 #include <QDebug>
 
 #ifdef Q_OS_MACOS
@@ -13,95 +14,370 @@
 #include <psapi.h>
 #endif
 
+namespace {
+
+// 累计分配最多的几个模块，例如 "#3 Example Module (12.5 MB, CPU 1.20 s)"
+QString heaviestModulesSummary(int count) {
+    QStringList entries;
+    const QList<ModuleAccounting::ModuleUsage> modules = ModuleAccounting::topModules(count);
+    for (const ModuleAccounting::ModuleUsage& module : modules) {
+        if (module.usage.allocatedBytes == 0 && module.usage.cpuTimeUs == 0) {
+            continue;
+        }
+        entries << QString("#%1 %2 (%3 MB, CPU %4 s)")
+                       .arg(module.moduleId)
+                       .arg(module.title)
+                       .arg(module.usage.allocatedBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                       .arg(module.usage.cpuTimeUs / 1000000.0, 0, 'f', 2);
+    }
+    return entries.join(", ");
+}
+
+const int SUMMARY_MODULE_COUNT = 3;
+
+} // namespace
+
 PerformanceMonitor::PerformanceMonitor(QObject *parent)
     : QObject(parent)
+    , m_sampleScheduled(false)
     , m_cpuThreshold(80.0)
     , m_memoryThreshold(85.0)
     , m_processMemoryThreshold(1024) // 1GB
+    , m_admissionWindowSeconds(10)
+    , m_admissionStatistic(Mean)
+    , m_uiJankGating(true)
     , m_lastCPUTime(0)
     , m_lastSystemTime(0)
 {
-    // 初始化定时器，每2秒更新一次性能数据
-    m_updateTimer = new QTimer(this);
-    connect(m_updateTimer, &QTimer::timeout, this, &PerformanceMonitor::updateMetrics);
-    m_updateTimer->start(2000);
+    m_admissionClock.start();
+
+    // 采样线程：定时器属于该线程，每2秒更新一次性能数据
+    m_samplerThread = new QThread(this);
+    m_samplerThread->setObjectName("PerformanceSampler");
+
+    m_updateTimer = new QTimer();
+    m_updateTimer->setInterval(SAMPLE_INTERVAL_MS);
+    m_updateTimer->moveToThread(m_samplerThread);
 
-    // 立即更新一次
-    updateMetrics();
+    // 以定时器为上下文对象，保证回调运行在采样线程
+    connect(m_updateTimer, &QTimer::timeout, m_updateTimer, [this]() {
+        updateMetrics();
+    });
+    connect(m_samplerThread, &QThread::started, m_updateTimer, [this]() {
+        // 线程启动后立即采样一次，不再阻塞构造函数
+        updateMetrics();
+        m_updateTimer->start();
+    });
+    connect(m_samplerThread, &QThread::finished, m_updateTimer, &QObject::deleteLater);
+
+    m_samplerThread->start(QThread::LowPriority);
 
     qDebug() << "[PerformanceMonitor] Initialized with thresholds:"
-             << "CPU:" << m_cpuThreshold << "%"
-             << "Memory:" << m_memoryThreshold << "%"
-             << "Process:" << m_processMemoryThreshold << "MB";
+             << "CPU:" << cpuThreshold() << "%"
+             << "Memory:" << memoryThreshold() << "%"
+             << "Process:" << processMemoryThreshold() << "MB";
 }
 
 PerformanceMonitor::~PerformanceMonitor() {
+    m_samplerThread->quit();
+    m_samplerThread->wait();
     qDebug() << "[PerformanceMonitor] Destroyed";
 }
 
 void PerformanceMonitor::updateMetrics() {
-    m_currentMetrics.cpuUsagePercent = getCPUUsage();
-    m_currentMetrics.memoryUsedMB = getSystemMemoryUsed();
-    m_currentMetrics.memoryTotalMB = getSystemMemoryTotal();
-    m_currentMetrics.processMemoryMB = getProcessMemoryUsage();
-
-    if (m_currentMetrics.memoryTotalMB > 0) {
-        m_currentMetrics.memoryUsagePercent =
-            (double)m_currentMetrics.memoryUsedMB / m_currentMetrics.memoryTotalMB * 100.0;
+    PerformanceMetrics metrics = PerformanceMetrics{0.0, 0, 0, 0.0, 0, false, false, 0.0};
+
+    metrics.cpuUsagePercent = getCPUUsage();
+    metrics.memoryUsedMB = getSystemMemoryUsed();
+    metrics.memoryTotalMB = getSystemMemoryTotal();
+    metrics.processMemoryMB = getProcessMemoryUsage();
+
+#ifdef Q_OS_LINUX
+    metrics.memoryLimitedByCgroup = m_procSampler.isMemoryLimited();
+    metrics.cpuLimitedByCgroup = m_procSampler.isCpuLimited();
+    metrics.cpuLimitCores = m_procSampler.cpuLimitCores();
+#endif
+
+    if (metrics.memoryTotalMB > 0) {
+        metrics.memoryUsagePercent =
+            (double)metrics.memoryUsedMB / metrics.memoryTotalMB * 100.0;
     } else {
-        m_currentMetrics.memoryUsagePercent = 0.0;
+        metrics.memoryUsagePercent = 0.0;
     }
 
-    // 检查是否超过警告阈值
-    if (m_currentMetrics.cpuUsagePercent > m_cpuThreshold * 0.9) {
-        emit performanceWarning(QString("CPU usage high: %1%").arg(m_currentMetrics.cpuUsagePercent, 0, 'f', 1));
+    // 发布快照（读取方无锁）
+    m_currentMetrics.store(metrics);
+
+    m_history.append(MetricsHistory::Sample{metrics.cpuUsagePercent,
+                                            metrics.memoryUsagePercent,
+                                            double(metrics.processMemoryMB)});
+    m_publishedHistory.store(m_history);
+
+    // 通知GUI线程处理新样本；GUI线程尚未处理上一次时不重复投递
+    if (!m_sampleScheduled.exchange(true)) {
+        QMetaObject::invokeMethod(this, [this]() { onSampleAvailable(); }, Qt::QueuedConnection);
     }
-    if (m_currentMetrics.memoryUsagePercent > m_memoryThreshold * 0.9) {
-        emit performanceWarning(QString("Memory usage high: %1%").arg(m_currentMetrics.memoryUsagePercent, 0, 'f', 1));
+}
+
+AdmissionController::Usage PerformanceMonitor::usageOf(const PerformanceMetrics& metrics) const {
+    return AdmissionController::Usage{metrics.cpuUsagePercent,
+                                      metrics.memoryUsagePercent,
+                                      double(metrics.memoryTotalMB),
+                                      double(metrics.processMemoryMB)};
+}
+
+AdmissionController::Limits PerformanceMonitor::currentLimits() const {
+    return AdmissionController::Limits{cpuThreshold(), memoryThreshold(), double(processMemoryThreshold())};
+}
+
+void PerformanceMonitor::onSampleAvailable() {
+    m_sampleScheduled.store(false);
+
+    const PerformanceMetrics metrics = getCurrentMetrics();
+    const AdmissionController::Usage usage = usageOf(metrics);
+
+    // 结算已经稳定的模块创建，更新各类型的开销估计
+    m_admission.observe(usage, m_admissionClock.elapsed());
+
+    // 迟滞：只有进入更高的压力等级时才通知，持续超限不会重复发出
+    const AdmissionController::Level memoryBefore = memoryPressure();
+    AdmissionController::Transition transitions[AdmissionController::RESOURCE_COUNT];
+    const int count = m_admission.updatePressure(usage, currentLimits(), transitions,
+                                                 AdmissionController::RESOURCE_COUNT);
+
+    QStringList warnings;
+    QStringList criticals;
+    for (int i = 0; i < count; ++i) {
+        const AdmissionController::Transition& t = transitions[i];
+        const QString name = AdmissionController::resourceName(t.resource);
+        const QString value = t.resource == AdmissionController::ProcessMemory
+                                  ? QString("%1 MB").arg(t.value, 0, 'f', 0)
+                                  : QString("%1%").arg(t.value, 0, 'f', 1);
+
+        if (t.to < t.from) {
+            qDebug() << "[PerformanceMonitor]" << name << "recovered:" << value;
+        } else if (t.to == AdmissionController::Critical) {
+            criticals << QString("%1 critical: %2").arg(name, value);
+        } else {
+            warnings << QString("%1 high: %2").arg(name, value);
+        }
+    }
+
+    // 附上占用最多的模块，方便先关闭它们
+    if (!criticals.isEmpty() || !warnings.isEmpty()) {
+        const QString heaviest = heaviestModulesSummary(SUMMARY_MODULE_COUNT);
+        if (!heaviest.isEmpty()) {
+            if (!criticals.isEmpty()) {
+                criticals << QString("Heaviest modules: %1").arg(heaviest);
+            }
+            if (!warnings.isEmpty()) {
+                warnings << QString("Heaviest modules: %1").arg(heaviest);
+            }
+        }
+    }
+
+    if (!criticals.isEmpty()) {
+        emit performanceCritical(criticals.join('\n'));
+    }
+    if (!warnings.isEmpty()) {
+        emit performanceWarning(warnings.join('\n'));
     }
+
+    const AdmissionController::Level memoryAfter = memoryPressure();
+    if (memoryAfter != memoryBefore) {
+        emit memoryPressureChanged(memoryAfter);
+    }
+}
+
+bool PerformanceMonitor::isMemoryCritical() const {
+    return m_admission.level(AdmissionController::SystemMemory) == AdmissionController::Critical ||
+           m_admission.level(AdmissionController::ProcessMemory) == AdmissionController::Critical;
+}
+
+AdmissionController::Level PerformanceMonitor::memoryPressure() const {
+    return qMax(m_admission.level(AdmissionController::SystemMemory),
+                m_admission.level(AdmissionController::ProcessMemory));
 }
 
-PerformanceMonitor::PerformanceMetrics PerformanceMonitor::getCurrentMetrics() {
-    return m_currentMetrics;
+void PerformanceMonitor::recordModuleCreation(int moduleType, int count) {
+    // 以最近一次样本作为创建前的基准，两次采样后结算增量（同一时段的多次创建平分增量）
+    const AdmissionController::Usage before = usageOf(getCurrentMetrics());
+    const qint64 now = m_admissionClock.elapsed();
+    for (int i = 0; i < count; ++i) {
+        m_admission.recordCreation(moduleType, before, now);
+    }
 }
 
+PerformanceMonitor::PerformanceMetrics PerformanceMonitor::getCurrentMetrics() const {
+    return m_currentMetrics.load();
+}
+
+PerformanceMonitor::UiLatency PerformanceMonitor::getUiLatency() const {
+    UiLatency latency = UiLatency{{0, 0.0, 0.0, 0.0}, {0, 0.0, 0.0, 0.0}, 0, false};
+
+    EventLoopMonitor* loop = EventLoopMonitor::instance();
+    if (loop) {
+        latency.frameInterval = loop->frameIntervalStats();
+        latency.eventDuration = loop->eventDurationStats();
+        latency.stallCount = loop->stallCount();
+        latency.janky = loop->isUiJanky();
+    }
+    return latency;
+}
+
+MetricsHistory PerformanceMonitor::metricsHistory() const {
+    return m_publishedHistory.load();
+}
+
+MetricsHistory::WindowStats PerformanceMonitor::windowStats(MetricsHistory::Metric metric, int seconds) const {
+    const int samples = qMax(1, seconds * 1000 / SAMPLE_INTERVAL_MS);
+    return metricsHistory().stats(metric, samples);
+}
+
+void PerformanceMonitor::setAdmissionWindow(int seconds, AdmissionStatistic statistic) {
+    m_admissionWindowSeconds.store(qMax(0, seconds));
+    m_admissionStatistic.store(statistic);
+}
+
+namespace {
+
+double pickStatistic(const MetricsHistory::WindowStats& stats,
+                     PerformanceMonitor::AdmissionStatistic statistic,
+                     double instant) {
+    if (stats.count == 0) {
+        return instant;
+    }
+    switch (statistic) {
+        case PerformanceMonitor::Minimum:
+            return stats.min;
+        case PerformanceMonitor::Mean:
+            return stats.mean;
+        case PerformanceMonitor::P95:
+            return stats.p95;
+        case PerformanceMonitor::Maximum:
+            return stats.max;
+        case PerformanceMonitor::Instant:
+            break;
+    }
+    return instant;
+}
+
+QString statisticLabel(PerformanceMonitor::AdmissionStatistic statistic, int seconds) {
+    if (seconds <= 0) {
+        return QString("当前");
+    }
+    switch (statistic) {
+        case PerformanceMonitor::Minimum:
+            return QString("%1秒最小值").arg(seconds);
+        case PerformanceMonitor::Mean:
+            return QString("%1秒平均").arg(seconds);
+        case PerformanceMonitor::P95:
+            return QString("%1秒P95").arg(seconds);
+        case PerformanceMonitor::Maximum:
+            return QString("%1秒最大值").arg(seconds);
+        case PerformanceMonitor::Instant:
+            break;
+    }
+    return QString("当前");
+}
+
+} // namespace
+
 bool PerformanceMonitor::canCreateNewModule(QString* reason) {
-    PerformanceMetrics metrics = getCurrentMetrics();
+    return canCreateNewModule(-1, reason);
+}
 
-    // 检查CPU使用率
-    if (metrics.cpuUsagePercent > m_cpuThreshold) {
-        if (reason) {
-            *reason = QString("CPU使用率过高 (%1% > %2%)\n"
-                            "当前系统负载较重，创建更多模块可能导致性能下降")
-                        .arg(metrics.cpuUsagePercent, 0, 'f', 1)
-                        .arg(m_cpuThreshold, 0, 'f', 1);
-        }
-        return false;
+bool PerformanceMonitor::canCreateNewModule(int moduleType, QString* reason) {
+    return canCreateNewModules(moduleType, 1, reason);
+}
+
+bool PerformanceMonitor::canCreateNewModules(int moduleType, int count, QString* reason) {
+    PerformanceMetrics metrics = getCurrentMetrics();
+    const double cpuLimit = cpuThreshold();
+    const double memoryLimit = memoryThreshold();
+    const quint64 processLimit = processMemoryThreshold();
+
+    // 用窗口统计值代替单次样本，避免短暂尖峰导致判断来回跳动
+    const AdmissionStatistic statistic = admissionStatistic();
+    const int windowSeconds = admissionWindowSeconds();
+    if (statistic != Instant && windowSeconds > 0) {
+        const MetricsHistory history = metricsHistory();
+        const int samples = qMax(1, windowSeconds * 1000 / SAMPLE_INTERVAL_MS);
+        metrics.cpuUsagePercent = pickStatistic(history.stats(MetricsHistory::CpuUsage, samples),
+                                                statistic, metrics.cpuUsagePercent);
+        metrics.memoryUsagePercent = pickStatistic(history.stats(MetricsHistory::MemoryUsage, samples),
+                                                   statistic, metrics.memoryUsagePercent);
+        metrics.processMemoryMB = quint64(pickStatistic(history.stats(MetricsHistory::ProcessMemory, samples),
+                                                        statistic, double(metrics.processMemoryMB)));
     }
+    const QString label = statisticLabel(statistic, windowSeconds);
+
+    // 预测：当前值加上该类型模块的预计开销（尚无学习数据时开销为0，等同于只看当前值）
+    const AdmissionController::Prediction prediction =
+        m_admission.predict(moduleType, usageOf(metrics), currentLimits(), count);
 
-    // 检查系统内存使用率
-    if (metrics.memoryUsagePercent > m_memoryThreshold) {
+    if (!prediction.allowed) {
         if (reason) {
-            *reason = QString("系统内存使用率过高 (%1% > %2%)\n"
-                            "可用内存: %3 MB / %4 MB\n"
-                            "创建更多模块可能导致系统卡顿")
-                        .arg(metrics.memoryUsagePercent, 0, 'f', 1)
-                        .arg(m_memoryThreshold, 0, 'f', 1)
-                        .arg(metrics.memoryTotalMB - metrics.memoryUsedMB)
-                        .arg(metrics.memoryTotalMB);
+            const double increase = prediction.predicted - prediction.current;
+            switch (prediction.resource) {
+                case AdmissionController::Cpu:
+                    // 检查CPU使用率（容器中相对cpu.max配额）
+                    *reason = QString("%1使用率过高 (%2: %3% + 预计%4% > %5%)\n"
+                                    "当前系统负载较重，创建更多模块可能导致性能下降")
+                                .arg(metrics.cpuLimitedByCgroup
+                                         ? QString("容器CPU配额(%1核)").arg(metrics.cpuLimitCores, 0, 'f', 2)
+                                         : QString("CPU"))
+                                .arg(label)
+                                .arg(prediction.current, 0, 'f', 1)
+                                .arg(increase, 0, 'f', 1)
+                                .arg(cpuLimit, 0, 'f', 1);
+                    break;
+                case AdmissionController::SystemMemory:
+                    // 检查系统内存使用率（容器中相对memory.max）
+                    *reason = QString("%1使用率过高 (%2: %3% + 预计%4% > %5%)\n"
+                                    "可用内存: %6 MB / %7 MB\n"
+                                    "创建更多模块可能导致系统卡顿")
+                                .arg(metrics.memoryLimitedByCgroup ? "容器内存" : "系统内存")
+                                .arg(label)
+                                .arg(prediction.current, 0, 'f', 1)
+                                .arg(increase, 0, 'f', 1)
+                                .arg(memoryLimit, 0, 'f', 1)
+                                .arg(metrics.memoryTotalMB - metrics.memoryUsedMB)
+                                .arg(metrics.memoryTotalMB);
+                    break;
+                case AdmissionController::ProcessMemory:
+                case AdmissionController::RESOURCE_COUNT:
+                    // 检查进程内存使用
+                    *reason = QString("应用程序内存使用过多 (%1: %2 MB + 预计%3 MB > %4 MB)\n"
+                                    "建议关闭一些模块后再创建新模块")
+                                .arg(label)
+                                .arg(prediction.current, 0, 'f', 0)
+                                .arg(increase, 0, 'f', 0)
+                                .arg(processLimit);
+                    {
+                        const QString heaviest = heaviestModulesSummary(SUMMARY_MODULE_COUNT);
+                        if (!heaviest.isEmpty()) {
+                            *reason += QString("\n占用最多的模块: %1").arg(heaviest);
+                        }
+                    }
+                    break;
+            }
         }
         return false;
     }
 
-    // 检查进程内存使用
-    if (metrics.processMemoryMB > m_processMemoryThreshold) {
-        if (reason) {
-            *reason = QString("应用程序内存使用过多 (%1 MB > %2 MB)\n"
-                            "建议关闭一些模块后再创建新模块")
-                        .arg(metrics.processMemoryMB)
-                        .arg(m_processMemoryThreshold);
+    // 检查界面是否已经卡顿
+    if (isUiJankGatingEnabled()) {
+        const UiLatency latency = getUiLatency();
+        if (latency.janky) {
+            if (reason) {
+                *reason = QString("界面响应变慢 (帧间隔P99: %1 ms, 最长事件: %2 ms)\n"
+                                "请等待界面恢复流畅后再创建新模块")
+                            .arg(latency.frameInterval.p99Ms, 0, 'f', 1)
+                            .arg(latency.eventDuration.maxMs, 0, 'f', 1);
+            }
+            return false;
         }
-        return false;
     }
 
     return true;
@@ -165,6 +441,10 @@ double PerformanceMonitor::getCPUUsage() {
     }
 #endif
 
+#ifdef Q_OS_LINUX
+    return m_procSampler.cpuUsagePercent();
+#endif
+
     return 0.0; // 返回0表示无法获取
 }
 
@@ -193,6 +473,10 @@ quint64 PerformanceMonitor::getSystemMemoryUsed() {
     }
 #endif
 
+#ifdef Q_OS_LINUX
+    return m_procSampler.systemMemoryUsedMB();
+#endif
+
     return 0;
 }
 
@@ -215,6 +499,10 @@ quint64 PerformanceMonitor::getSystemMemoryTotal() {
     }
 #endif
 
+#ifdef Q_OS_LINUX
+    return m_procSampler.systemMemoryTotalMB();
+#endif
+
     return 0;
 }
 
@@ -235,5 +523,9 @@ quint64 PerformanceMonitor::getProcessMemoryUsage() {
     }
 #endif
 
+#ifdef Q_OS_LINUX
+    return m_procSampler.processMemoryMB();
+#endif
+
     return 0;
 }
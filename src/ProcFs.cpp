@@ -0,0 +1,508 @@
+#include "ProcFs.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace ProcFs {
+
+namespace {
+
+// 跳过空白（不含换行）
+const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    return p;
+}
+
+// 读取一个无符号整数，失败时返回nullptr
+const char* parseNumber(const char* p, const char* end, quint64* value) {
+    p = skipSpaces(p, end);
+    if (p >= end || *p < '0' || *p > '9') {
+        return nullptr;
+    }
+    quint64 result = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        result = result * 10 + quint64(*p - '0');
+        ++p;
+    }
+    *value = result;
+    return p;
+}
+
+// 移动到下一行开头
+const char* nextLine(const char* p, const char* end) {
+    while (p < end && *p != '\n') {
+        ++p;
+    }
+    return p < end ? p + 1 : end;
+}
+
+bool startsWith(const char* p, const char* end, const char* prefix) {
+    const size_t n = std::strlen(prefix);
+    return size_t(end - p) >= n && std::memcmp(p, prefix, n) == 0;
+}
+
+} // namespace
+
+bool parseCpuTimes(const char* data, qsizetype length, CpuTimes* out) {
+    const char* p = data;
+    const char* end = data + length;
+
+    // 第一行格式: "cpu  user nice system idle iowait irq softirq steal guest guest_nice"
+    if (!startsWith(p, end, "cpu ")) {
+        return false;
+    }
+    p += 3;
+
+    quint64 fields[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    int count = 0;
+    while (count < 8) {
+        const char* next = parseNumber(p, end, &fields[count]);
+        if (!next) {
+            break;
+        }
+        p = next;
+        ++count;
+    }
+
+    // 旧内核至少提供user/nice/system/idle四项
+    if (count < 4) {
+        return false;
+    }
+
+    // guest/guest_nice已经计入user/nice，不重复累加
+    out->total = 0;
+    for (int i = 0; i < count; ++i) {
+        out->total += fields[i];
+    }
+    out->idle = fields[3] + fields[4];
+    return true;
+}
+
+bool parseMemInfo(const char* data, qsizetype length, MemInfo* out) {
+    const char* p = data;
+    const char* end = data + length;
+
+    bool hasTotal = false;
+    bool hasAvailable = false;
+    quint64 freeKB = 0;
+    quint64 buffersKB = 0;
+    quint64 cachedKB = 0;
+
+    while (p < end && !(hasTotal && hasAvailable)) {
+        if (startsWith(p, end, "MemTotal:")) {
+            hasTotal = parseNumber(p + 9, end, &out->totalKB) != nullptr;
+        } else if (startsWith(p, end, "MemAvailable:")) {
+            hasAvailable = parseNumber(p + 13, end, &out->availableKB) != nullptr;
+        } else if (startsWith(p, end, "MemFree:")) {
+            parseNumber(p + 8, end, &freeKB);
+        } else if (startsWith(p, end, "Buffers:")) {
+            parseNumber(p + 8, end, &buffersKB);
+        } else if (startsWith(p, end, "Cached:")) {
+            parseNumber(p + 7, end, &cachedKB);
+        }
+        p = nextLine(p, end);
+    }
+
+    if (!hasTotal) {
+        return false;
+    }
+
+    // 3.14之前的内核没有MemAvailable，用Free+Buffers+Cached近似
+    if (!hasAvailable) {
+        out->availableKB = qMin(out->totalKB, freeKB + buffersKB + cachedKB);
+    }
+    return true;
+}
+
+bool parseStatmResident(const char* data, qsizetype length, quint64* residentPages) {
+    const char* end = data + length;
+
+    // 格式: "size resident shared text lib data dt"（单位: 页）
+    quint64 size = 0;
+    const char* p = parseNumber(data, end, &size);
+    if (!p) {
+        return false;
+    }
+    return parseNumber(p, end, residentPages) != nullptr;
+}
+
+bool parseCgroupPath(const char* data, qsizetype length, char* out, qsizetype capacity) {
+    const char* p = data;
+    const char* end = data + length;
+
+    // cgroup v2的统一层级固定为 "0::<path>"；v1的其它行忽略
+    while (p < end) {
+        if (startsWith(p, end, "0::")) {
+            p += 3;
+            qsizetype n = 0;
+            while (p < end && *p != '\n' && n < capacity - 1) {
+                out[n++] = *p++;
+            }
+            out[n] = '\0';
+            return n > 0;
+        }
+        p = nextLine(p, end);
+    }
+    return false;
+}
+
+bool parseLimitValue(const char* data, qsizetype length, quint64* value, bool* unlimited) {
+    const char* end = data + length;
+    const char* p = skipSpaces(data, end);
+
+    if (startsWith(p, end, "max")) {
+        *unlimited = true;
+        *value = 0;
+        return true;
+    }
+
+    *unlimited = false;
+    return parseNumber(p, end, value) != nullptr;
+}
+
+bool parseCpuMax(const char* data, qsizetype length, quint64* quotaUsec, quint64* periodUsec, bool* unlimited) {
+    const char* end = data + length;
+    const char* p = skipSpaces(data, end);
+
+    if (startsWith(p, end, "max")) {
+        *unlimited = true;
+        *quotaUsec = 0;
+        p += 3;
+    } else {
+        *unlimited = false;
+        p = parseNumber(p, end, quotaUsec);
+        if (!p) {
+            return false;
+        }
+    }
+
+    return parseNumber(p, end, periodUsec) != nullptr && *periodUsec > 0;
+}
+
+bool parseKeyedValue(const char* data, qsizetype length, const char* key, quint64* value) {
+    const char* p = data;
+    const char* end = data + length;
+    const size_t keyLength = std::strlen(key);
+
+    while (p < end) {
+        // 键后必须紧跟空白，避免 "usage_usec" 匹配到 "usage_usec_total" 之类的前缀
+        if (startsWith(p, end, key) && p + keyLength < end &&
+            (p[keyLength] == ' ' || p[keyLength] == '\t')) {
+            return parseNumber(p + keyLength, end, value) != nullptr;
+        }
+        p = nextLine(p, end);
+    }
+    return false;
+}
+
+// File 实现
+
+File::File()
+    : m_fd(-1)
+{
+}
+
+File::~File() {
+    close();
+}
+
+bool File::open(const char* path) {
+    close();
+#ifdef Q_OS_UNIX
+    m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+#else
+    Q_UNUSED(path);
+#endif
+    return m_fd >= 0;
+}
+
+void File::close() {
+#ifdef Q_OS_UNIX
+    if (m_fd >= 0) {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+}
+
+qsizetype File::read(char* buffer, qsizetype capacity) {
+    if (m_fd < 0 || capacity <= 0) {
+        return -1;
+    }
+#ifdef Q_OS_UNIX
+    // /proc文件每次从偏移0读取都会重新生成内容，无需重新打开
+    ssize_t n = ::pread(m_fd, buffer, size_t(capacity - 1), 0);
+    if (n < 0) {
+        return -1;
+    }
+    buffer[n] = '\0';
+    return qsizetype(n);
+#else
+    Q_UNUSED(buffer);
+    return -1;
+#endif
+}
+
+// Sampler 实现
+
+Sampler::Sampler(const char* procRoot, const char* cgroupRoot)
+    : m_pageSize(4096)
+    , m_lastCpu{0, 0}
+    , m_hasLastCpu(false)
+    , m_hasCgroup(false)
+    , m_memoryLimited(false)
+    , m_memoryLimitBytes(0)
+    , m_cpuLimited(false)
+    , m_cpuLimitCores(0.0)
+    , m_lastCgroupUsageUsec(0)
+    , m_lastCgroupSampleUsec(0)
+    , m_hasLastCgroupCpu(false)
+{
+    char path[512];
+
+    std::snprintf(path, sizeof(path), "%s/stat", procRoot);
+    m_statFile.open(path);
+
+    std::snprintf(path, sizeof(path), "%s/meminfo", procRoot);
+    m_meminfoFile.open(path);
+
+    std::snprintf(path, sizeof(path), "%s/self/statm", procRoot);
+    m_statmFile.open(path);
+
+#ifdef Q_OS_UNIX
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize > 0) {
+        m_pageSize = quint64(pageSize);
+    }
+#endif
+
+    m_buffer[0] = '\0';
+
+    // 查找进程所在的cgroup（只需在启动时读取一次）
+    std::snprintf(path, sizeof(path), "%s/self/cgroup", procRoot);
+    File cgroupFile;
+    if (cgroupFile.open(path)) {
+        qsizetype n = cgroupFile.read(m_buffer, BUFFER_SIZE);
+        char cgroupPath[PATH_SIZE];
+        if (n > 0 && parseCgroupPath(m_buffer, n, cgroupPath, PATH_SIZE)) {
+            char fullPath[PATH_SIZE];
+            std::snprintf(fullPath, sizeof(fullPath), "%s%s", cgroupRoot,
+                          std::strcmp(cgroupPath, "/") == 0 ? "" : cgroupPath);
+            openCgroupFiles(fullPath);
+        }
+    }
+}
+
+void Sampler::openCgroupFiles(const char* cgroupDir) {
+    char path[PATH_SIZE];
+
+    std::snprintf(path, sizeof(path), "%s/memory.current", cgroupDir);
+    m_memoryCurrentFile.open(path);
+    std::snprintf(path, sizeof(path), "%s/memory.stat", cgroupDir);
+    m_memoryStatFile.open(path);
+    std::snprintf(path, sizeof(path), "%s/cpu.stat", cgroupDir);
+    m_cpuStatFile.open(path);
+
+    m_hasCgroup = m_memoryCurrentFile.isOpen() || m_cpuStatFile.isOpen();
+    if (!m_hasCgroup) {
+        return;
+    }
+
+    // 从叶子向上逐级打开限制文件，直到cgroup挂载点（不存在的层级直接跳过）
+    char dir[PATH_SIZE];
+    std::snprintf(dir, sizeof(dir), "%s", cgroupDir);
+    for (int level = 0; level < MAX_CGROUP_LEVELS; ++level) {
+        std::snprintf(path, sizeof(path), "%s/memory.max", dir);
+        m_memoryMaxFiles[level].open(path);
+        std::snprintf(path, sizeof(path), "%s/cpu.max", dir);
+        m_cpuMaxFiles[level].open(path);
+
+        // 去掉最后一级目录；没有cgroup.controllers的上级已经不属于cgroup层级
+        char* slash = std::strrchr(dir, '/');
+        if (!slash || slash == dir) {
+            break;
+        }
+        *slash = '\0';
+
+        std::snprintf(path, sizeof(path), "%s/cgroup.controllers", dir);
+        File probe;
+        if (!probe.open(path)) {
+            break;
+        }
+    }
+}
+
+bool Sampler::isValid() const {
+    return m_statFile.isOpen() && m_meminfoFile.isOpen() && m_statmFile.isOpen();
+}
+
+double Sampler::cpuUsagePercent() {
+    quint64 nowUsec = 0;
+#ifdef Q_OS_UNIX
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    nowUsec = quint64(ts.tv_sec) * 1000000 + quint64(ts.tv_nsec) / 1000;
+#endif
+    return cpuUsagePercentAt(nowUsec);
+}
+
+double Sampler::cpuUsagePercentAt(quint64 monotonicUsec) {
+    // 主机计数始终更新，这样配额被取消时也有可用的基准
+    double hostUsage = hostCpuUsagePercent();
+
+    refreshCpuLimit();
+    if (m_cpuLimited) {
+        return cgroupCpuUsagePercent(monotonicUsec);
+    }
+    return hostUsage;
+}
+
+double Sampler::hostCpuUsagePercent() {
+    qsizetype n = m_statFile.read(m_buffer, BUFFER_SIZE);
+    CpuTimes now;
+    if (n <= 0 || !parseCpuTimes(m_buffer, n, &now)) {
+        return 0.0;
+    }
+
+    double usage = 0.0;
+    if (m_hasLastCpu && now.total > m_lastCpu.total) {
+        quint64 totalDiff = now.total - m_lastCpu.total;
+        quint64 idleDiff = now.idle >= m_lastCpu.idle ? now.idle - m_lastCpu.idle : 0;
+        usage = 100.0 * (1.0 - (double)idleDiff / totalDiff);
+        usage = qMax(0.0, qMin(100.0, usage));
+    }
+
+    m_lastCpu = now;
+    m_hasLastCpu = true;
+    return usage;
+}
+
+double Sampler::cgroupCpuUsagePercent(quint64 monotonicUsec) {
+    qsizetype n = m_cpuStatFile.read(m_buffer, BUFFER_SIZE);
+    quint64 usageUsec = 0;
+    if (n <= 0 || !parseKeyedValue(m_buffer, n, "usage_usec", &usageUsec)) {
+        return 0.0;
+    }
+
+    // 使用率 = CPU时间增量 / (墙钟时间增量 * 配额核数)
+    double usage = 0.0;
+    if (m_hasLastCgroupCpu && monotonicUsec > m_lastCgroupSampleUsec && m_cpuLimitCores > 0.0) {
+        quint64 usageDiff = usageUsec >= m_lastCgroupUsageUsec ? usageUsec - m_lastCgroupUsageUsec : 0;
+        quint64 wallDiff = monotonicUsec - m_lastCgroupSampleUsec;
+        usage = 100.0 * (double)usageDiff / ((double)wallDiff * m_cpuLimitCores);
+        usage = qMax(0.0, qMin(100.0, usage));
+    }
+
+    m_lastCgroupUsageUsec = usageUsec;
+    m_lastCgroupSampleUsec = monotonicUsec;
+    m_hasLastCgroupCpu = true;
+    return usage;
+}
+
+void Sampler::refreshCpuLimit() {
+    m_cpuLimited = false;
+    m_cpuLimitCores = 0.0;
+    if (!m_hasCgroup || !m_cpuStatFile.isOpen()) {
+        return;
+    }
+
+    // 各级cpu.max中最严格的配额生效
+    for (int level = 0; level < MAX_CGROUP_LEVELS; ++level) {
+        qsizetype n = m_cpuMaxFiles[level].read(m_buffer, BUFFER_SIZE);
+        quint64 quota = 0;
+        quint64 period = 0;
+        bool unlimited = true;
+        if (n <= 0 || !parseCpuMax(m_buffer, n, &quota, &period, &unlimited) || unlimited) {
+            continue;
+        }
+        double cores = (double)quota / period;
+        if (!m_cpuLimited || cores < m_cpuLimitCores) {
+            m_cpuLimitCores = cores;
+            m_cpuLimited = true;
+        }
+    }
+}
+
+void Sampler::refreshMemoryLimit() {
+    m_memoryLimited = false;
+    m_memoryLimitBytes = 0;
+    if (!m_hasCgroup || !m_memoryCurrentFile.isOpen()) {
+        return;
+    }
+
+    // 各级memory.max中最小的限制生效
+    for (int level = 0; level < MAX_CGROUP_LEVELS; ++level) {
+        qsizetype n = m_memoryMaxFiles[level].read(m_buffer, BUFFER_SIZE);
+        quint64 limit = 0;
+        bool unlimited = true;
+        if (n <= 0 || !parseLimitValue(m_buffer, n, &limit, &unlimited) || unlimited) {
+            continue;
+        }
+        if (!m_memoryLimited || limit < m_memoryLimitBytes) {
+            m_memoryLimitBytes = limit;
+            m_memoryLimited = true;
+        }
+    }
+}
+
+bool Sampler::readMemInfo(MemInfo* out) {
+    qsizetype n = m_meminfoFile.read(m_buffer, BUFFER_SIZE);
+    return n > 0 && parseMemInfo(m_buffer, n, out);
+}
+
+quint64 Sampler::systemMemoryUsedMB() {
+    MemInfo info;
+    if (!readMemInfo(&info)) {
+        return 0;
+    }
+    quint64 usedKB = info.totalKB > info.availableKB ? info.totalKB - info.availableKB : 0;
+
+    refreshMemoryLimit();
+    if (m_memoryLimited && m_memoryLimitBytes / 1024 < info.totalKB) {
+        qsizetype n = m_memoryCurrentFile.read(m_buffer, BUFFER_SIZE);
+        quint64 currentBytes = 0;
+        if (n > 0 && parseNumber(m_buffer, m_buffer + n, &currentBytes)) {
+            // 与docker/kubelet一致：工作集 = memory.current - inactive_file（可回收的页缓存）
+            quint64 inactiveFile = 0;
+            n = m_memoryStatFile.read(m_buffer, BUFFER_SIZE);
+            if (n > 0 && parseKeyedValue(m_buffer, n, "inactive_file", &inactiveFile)) {
+                currentBytes = currentBytes > inactiveFile ? currentBytes - inactiveFile : 0;
+            }
+            return currentBytes / (1024 * 1024);
+        }
+    }
+
+    return usedKB / 1024;
+}
+
+quint64 Sampler::systemMemoryTotalMB() {
+    MemInfo info;
+    if (!readMemInfo(&info)) {
+        return 0;
+    }
+
+    // 容器限制比主机内存还大时，实际可用的仍然是主机内存
+    refreshMemoryLimit();
+    if (m_memoryLimited && m_memoryLimitBytes / 1024 < info.totalKB) {
+        return m_memoryLimitBytes / (1024 * 1024);
+    }
+    return info.totalKB / 1024;
+}
+
+quint64 Sampler::processMemoryMB() {
+    qsizetype n = m_statmFile.read(m_buffer, BUFFER_SIZE);
+    quint64 residentPages = 0;
+    if (n <= 0 || !parseStatmResident(m_buffer, n, &residentPages)) {
+        return 0;
+    }
+    return residentPages * m_pageSize / (1024 * 1024);
+}
+
+} // namespace ProcFs
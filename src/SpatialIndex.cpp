@@ -0,0 +1,144 @@
+#include "SpatialIndex.h"
+
+SpatialIndex::SpatialIndex(int cellSize)
+    : m_cellSize(qMax(1, cellSize))
+{
+}
+
+int SpatialIndex::cellOf(int coordinate) const {
+    // 向下取整，负坐标也落在正确的格子中
+    return coordinate >= 0 ? coordinate / m_cellSize : -((-(coordinate + 1)) / m_cellSize) - 1;
+}
+
+void SpatialIndex::insert(int key, const QRect& rect) {
+    remove(key);
+    if (rect.isEmpty()) {
+        return;
+    }
+    m_rects.insert(key, rect);
+    forEachCell(rect, [this, key](quint64 cell, int, int) {
+        m_cells[cell].append(key);
+        return true;
+    });
+}
+
+bool SpatialIndex::remove(int key) {
+    auto it = m_rects.find(key);
+    if (it == m_rects.end()) {
+        return false;
+    }
+    const QRect rect = it.value();
+    m_rects.erase(it);
+
+    forEachCell(rect, [this, key](quint64 cell, int, int) {
+        auto cellIt = m_cells.find(cell);
+        if (cellIt == m_cells.end()) {
+            return true;
+        }
+        // 格子中的顺序无关紧要，用末尾元素填补空位
+        QList<int>& keys = cellIt.value();
+        for (int i = 0; i < keys.size(); ++i) {
+            if (keys[i] == key) {
+                keys[i] = keys.last();
+                keys.removeLast();
+                break;
+            }
+        }
+        if (keys.isEmpty()) {
+            m_cells.erase(cellIt);
+        }
+        return true;
+    });
+    return true;
+}
+
+void SpatialIndex::clear() {
+    m_cells.clear();
+    m_rects.clear();
+}
+
+QList<int> SpatialIndex::at(const QPoint& point) const {
+    QList<int> result;
+    auto cellIt = m_cells.constFind(cellKey(cellOf(point.x()), cellOf(point.y())));
+    if (cellIt == m_cells.constEnd()) {
+        return result;
+    }
+    for (int key : cellIt.value()) {
+        if (m_rects.value(key).contains(point)) {
+            result.append(key);
+        }
+    }
+    return result;
+}
+
+QList<int> SpatialIndex::intersecting(const QRect& rect) const {
+    QList<int> result;
+    if (rect.isEmpty()) {
+        return result;
+    }
+    forEachCell(rect, [&](quint64 cell, int column, int row) {
+        auto cellIt = m_cells.constFind(cell);
+        if (cellIt == m_cells.constEnd()) {
+            return true;
+        }
+        for (int key : cellIt.value()) {
+            const QRect overlap = m_rects.value(key) & rect;
+            if (!overlap.isEmpty() && cellOf(overlap.left()) == column && cellOf(overlap.top()) == row) {
+                result.append(key);
+            }
+        }
+        return true;
+    });
+    return result;
+}
+
+bool SpatialIndex::intersectsAny(const QRect& rect) const {
+    bool found = false;
+    if (rect.isEmpty()) {
+        return found;
+    }
+    forEachCell(rect, [&](quint64 cell, int, int) {
+        auto cellIt = m_cells.constFind(cell);
+        if (cellIt != m_cells.constEnd()) {
+            for (int key : cellIt.value()) {
+                if (m_rects.value(key).intersects(rect)) {
+                    found = true;
+                    return false;
+                }
+            }
+        }
+        return true;
+    });
+    return found;
+}
+
+int SpatialIndex::nearest(const QRect& rect, int maxDistance) const {
+    int best = -1;
+    int bestDistance = maxDistance;
+    if (rect.isEmpty() || maxDistance < 0) {
+        return best;
+    }
+    // 间距不超过maxDistance的矩形一定与扩大后的查询矩形相交；跨格子的元素可能被看到多次，不影响结果
+    const QRect searchRect = rect.adjusted(-maxDistance, -maxDistance, maxDistance, maxDistance);
+    forEachCell(searchRect, [&](quint64 cell, int, int) {
+        auto cellIt = m_cells.constFind(cell);
+        if (cellIt == m_cells.constEnd()) {
+            return true;
+        }
+        for (int key : cellIt.value()) {
+            const int d = distance(rect, m_rects.value(key));
+            if (d < bestDistance || (d == bestDistance && (best < 0 || key < best))) {
+                best = key;
+                bestDistance = d;
+            }
+        }
+        return true;
+    });
+    return best;
+}
+
+int SpatialIndex::distance(const QRect& a, const QRect& b) {
+    const int dx = qMax(0, qMax(b.left() - a.right() - 1, a.left() - b.right() - 1));
+    const int dy = qMax(0, qMax(b.top() - a.bottom() - 1, a.top() - b.bottom() - 1));
+    return dx + dy;
+}
@@ -0,0 +1,187 @@
+#include "Trace.h"
+
+#ifdef MODULESYSTEM_TRACING
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QDebug>
+#include <atomic>
+#include <chrono>
+
+namespace Trace {
+
+namespace {
+
+struct Event {
+    const char* name;
+    qint64 startNs;
+    qint64 durationNs;
+    int arg;
+    char phase;
+};
+
+struct ThreadBuffer {
+    int tid;
+    QByteArray threadName;
+    std::atomic<quint64> written;   // 已写入的事件总数（包括被覆盖的）
+    Event events[EVENTS_PER_THREAD];
+};
+
+struct Registry {
+    QMutex mutex;
+    QList<ThreadBuffer*> buffers;   // 线程结束后保留，导出时仍然可见
+    int nextTid = 1;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+
+ThreadBuffer* threadBuffer() {
+    if (t_buffer) {
+        return t_buffer;
+    }
+
+    ThreadBuffer* buffer = new ThreadBuffer;
+    buffer->written.store(0, std::memory_order_relaxed);
+
+    QThread* thread = QThread::currentThread();
+    QCoreApplication* app = QCoreApplication::instance();
+    if (app && thread == app->thread()) {
+        buffer->threadName = "GUI";
+    } else if (thread && !thread->objectName().isEmpty()) {
+        buffer->threadName = thread->objectName().toUtf8();
+    }
+
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    buffer->tid = r.nextTid++;
+    if (buffer->threadName.isEmpty()) {
+        buffer->threadName = "Thread " + QByteArray::number(buffer->tid);
+    }
+    r.buffers.append(buffer);
+
+    t_buffer = buffer;
+    return buffer;
+}
+
+void record(const char* name, qint64 startNs, qint64 durationNs, int arg, char phase) {
+    ThreadBuffer* buffer = threadBuffer();
+    const quint64 index = buffer->written.load(std::memory_order_relaxed);
+    Event& event = buffer->events[index % EVENTS_PER_THREAD];
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    event.arg = arg;
+    event.phase = phase;
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+QByteArray escapeJson(const char* text) {
+    QByteArray escaped;
+    for (const char* p = text; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            escaped.append('\\');
+        }
+        escaped.append(*p);
+    }
+    return escaped;
+}
+
+QByteArray formatMicros(qint64 ns) {
+    return QByteArray::number(ns / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+qint64 nowNs() {
+    static const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origin).count();
+}
+
+void complete(const char* name, qint64 startNs, qint64 endNs, int arg) {
+    record(name, startNs, endNs - startNs, arg, 'X');
+}
+
+void instant(const char* name, int arg) {
+    record(name, nowNs(), 0, arg, 'i');
+}
+
+QByteArray toJson() {
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray json;
+    json.append("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    bool first = true;
+    auto separator = [&json, &first]() {
+        if (!first) {
+            json.append(",\n");
+        }
+        first = false;
+    };
+
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    for (ThreadBuffer* buffer : r.buffers) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+
+        // 线程名元数据
+        separator();
+        json.append("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":").append(pid)
+            .append(",\"tid\":").append(tid)
+            .append(",\"args\":{\"name\":\"").append(escapeJson(buffer->threadName.constData())).append("\"}}");
+
+        const quint64 written = buffer->written.load(std::memory_order_acquire);
+        const quint64 begin = written > quint64(EVENTS_PER_THREAD) ? written - EVENTS_PER_THREAD : 0;
+        for (quint64 i = begin; i < written; ++i) {
+            const Event& event = buffer->events[i % EVENTS_PER_THREAD];
+            separator();
+            json.append("{\"name\":\"").append(escapeJson(event.name))
+                .append("\",\"ph\":\"").append(event.phase)
+                .append("\",\"ts\":").append(formatMicros(event.startNs));
+            if (event.phase == 'X') {
+                json.append(",\"dur\":").append(formatMicros(event.durationNs));
+            } else {
+                json.append(",\"s\":\"t\"");
+            }
+            json.append(",\"pid\":").append(pid).append(",\"tid\":").append(tid);
+            if (event.arg >= 0) {
+                json.append(",\"args\":{\"id\":").append(QByteArray::number(event.arg)).append('}');
+            }
+            json.append('}');
+        }
+    }
+
+    json.append("]}\n");
+    return json;
+}
+
+bool dumpToFile(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[Trace] Cannot write trace file:" << path;
+        return false;
+    }
+    file.write(toJson());
+    qDebug() << "[Trace] Trace written to" << path;
+    return true;
+}
+
+void clear() {
+    Registry& r = registry();
+    QMutexLocker locker(&r.mutex);
+    for (ThreadBuffer* buffer : r.buffers) {
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
+
+} // namespace Trace
+
+#endif // MODULESYSTEM_TRACING
@@ -0,0 +1,365 @@
+#include <iostream>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "modules/ModuleManager.h"
+#include "ProcFs.h"
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 模块注册表基准测试（无界面）
+ *
+ * 用法：bench_modules [--headless] [模块数量，默认50000]
+ *
+ * 使用不创建内容控件的最小模块测量ModuleManager的注册、查询和销毁开销；
+ * 然后比较带完整界面的ExampleModule在有无实例池时的创建开销，
+ * 以及延迟构建时外壳与内容控件各自的创建耗时和常驻内存（RSS，仅Linux）。
+ * 默认使用offscreen平台，不需要显示器。
+ * 最后测量吸附/分离白板的往返耗时，并与重新设置父对象（重建原生窗口）的旧方式对比；
+ * 以及视口虚拟化中停放屏幕外模块和重新显示的耗时、释放的内存和停放后每个模块仍占用的内存。
+ * --headless：只使用QCoreApplication和无界面模块测量注册表开销，不创建任何控件。
+ */
+
+namespace {
+
+class BenchModule : public ModuleBase {
+public:
+    BenchModule() : ModuleBase(staticModuleType(), "Bench") {}
+
+    // 不在ModuleRegistry中，使用未注册类型的存储桶
+    static ModuleType staticModuleType() { return UserDefined; }
+    void clear() override { ModuleBase::clear(); }
+};
+
+void report(const char* phase, qint64 elapsedNs, int operations) {
+    std::cout << phase << ": " << elapsedNs / 1000000.0 << " ms";
+    if (operations > 0) {
+        std::cout << " (" << double(elapsedNs) / operations << " ns/op)";
+    }
+    std::cout << std::endl;
+}
+
+// 进程常驻内存（KB），不支持的平台返回0
+qint64 residentKB() {
+#ifdef Q_OS_LINUX
+    ProcFs::File statm;
+    char buffer[256];
+    quint64 pages = 0;
+    if (statm.open("/proc/self/statm")) {
+        const qsizetype length = statm.read(buffer, sizeof(buffer));
+        if (length > 0 && ProcFs::parseStatmResident(buffer, length, &pages)) {
+            return qint64(pages) * sysconf(_SC_PAGESIZE) / 1024;
+        }
+    }
+#endif
+    return 0;
+}
+
+void reportPerModule(const char* phase, qint64 elapsedNs, qint64 rssKB, int modules) {
+    std::cout << phase << ": " << elapsedNs / 1000.0 / modules << " us/module, "
+              << double(rssKB) / modules << " KB RSS/module" << std::endl;
+}
+
+int checkConsistency(const ModuleManager& manager, int found, int foundById, int stale, int count) {
+    if (found != count || foundById != count || stale != 0 || manager.totalModuleCount() != 0 ||
+        manager.moduleCountByType(BenchModule::staticModuleType()) != 0) {
+        std::cout << "Registry inconsistent: found " << found << " of " << count
+                  << ", " << manager.totalModuleCount() << " left" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    bool headless = false;
+    int count = 50000;
+    for (int i = 1; i < argc; ++i) {
+        if (QByteArray(argv[i]) == "--headless") {
+            headless = true;
+        } else {
+            count = qMax(1, QByteArray(argv[i]).toInt());
+        }
+    }
+
+    std::unique_ptr<QCoreApplication> app;
+    if (headless) {
+        app.reset(new QCoreApplication(argc, argv));
+    } else {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        app.reset(new QApplication(argc, argv));
+    }
+
+    // 每个模块都会输出调试日志，基准测试中关闭
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    std::cout << "Benchmarking module registry with " << count << " modules"
+              << (headless ? " (headless)" : "") << "..." << std::endl;
+
+    ModuleManager manager;
+    manager.setHibernationEnabled(false);
+
+    QElapsedTimer timer;
+
+    // 创建
+    std::vector<ModuleHandle> handles;
+    std::vector<int> ids;
+    handles.reserve(count);
+    ids.reserve(count);
+    timer.start();
+    for (int i = 0; i < count; ++i) {
+        QString reason;
+        ModuleHandle handle;
+        if (headless) {
+            handle = manager.createHeadlessModule<BenchModule>(&reason);
+        } else if (ModuleBase* module = manager.createModule<BenchModule>(&reason)) {
+            handle = module->moduleHandle();
+        }
+        if (handle.isNull()) {
+            std::cout << "Creation refused after " << i << " modules: " << reason.toStdString() << std::endl;
+            return 1;
+        }
+        handles.push_back(handle);
+        ids.push_back(manager.moduleId(handle));
+    }
+    report("create", timer.nsecsElapsed(), count);
+
+    // 随机顺序解析句柄 / 按ID查询
+    std::shuffle(handles.begin(), handles.end(), *QRandomGenerator::global());
+    std::shuffle(ids.begin(), ids.end(), *QRandomGenerator::global());
+    int found = 0;
+    timer.start();
+    for (ModuleHandle handle : handles) {
+        if (manager.contains(handle)) {
+            ++found;
+        }
+    }
+    report("resolve handle", timer.nsecsElapsed(), count);
+
+    int foundById = 0;
+    timer.start();
+    for (int id : ids) {
+        if (!manager.handleById(id).isNull()) {
+            ++foundById;
+        }
+    }
+    report("lookup by id", timer.nsecsElapsed(), count);
+
+    // 其它线程可用的快照：取得快照并遍历
+    int snapshotCount = 0;
+    timer.start();
+    manager.snapshot()->forEach([&snapshotCount](const ModuleInfo&) {
+        ++snapshotCount;
+    });
+    report("snapshot iterate", timer.nsecsElapsed(), count);
+    if (snapshotCount != count) {
+        std::cout << "Snapshot has " << snapshotCount << " of " << count << " modules" << std::endl;
+        return 1;
+    }
+
+    // 随机销毁一半
+    const int half = count / 2;
+    timer.start();
+    for (int i = 0; i < half; ++i) {
+        manager.destroyModule(handles[i]);
+    }
+    report("destroy (random order)", timer.nsecsElapsed(), half);
+
+    // 已销毁模块的句柄不能再解析
+    int stale = 0;
+    for (int i = 0; i < half; ++i) {
+        if (manager.contains(handles[i])) {
+            ++stale;
+        }
+    }
+
+    // 销毁剩余全部
+    const int remaining = manager.totalModuleCount();
+    timer.start();
+    manager.destroyAllModules();
+    report("destroy all", timer.nsecsElapsed(), remaining);
+
+    // 处理deleteLater
+    timer.start();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    report("deferred delete", timer.nsecsElapsed(), count);
+
+    // 批量创建/销毁：一次性能检查，一次通知
+    timer.start();
+    const int batchSize = headless ? manager.createHeadlessModules<BenchModule>(count).size()
+                                   : manager.createModules<BenchModule>(count).size();
+    report("create (batch)", timer.nsecsElapsed(), count);
+    if (batchSize != count) {
+        std::cout << "Batch creation refused" << std::endl;
+        return 1;
+    }
+    timer.start();
+    manager.destroyAllModules();
+    report("destroy all (batch)", timer.nsecsElapsed(), count);
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    if (headless) {
+        return checkConsistency(manager, found, foundById, stale, count);
+    }
+
+    // 注册类型（带完整界面）的创建：每次构造 vs 从实例池复用
+    const int widgetRounds = qMin(count, 1000);
+    const int poolCapacity = manager.poolCapacity();
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool pooled = pass == 1;
+        manager.setPoolCapacity(pooled ? poolCapacity : 0);
+        if (pooled) {
+            manager.prewarmPools();
+        }
+
+        timer.start();
+        for (int i = 0; i < widgetRounds; ++i) {
+            ExampleModule* module = manager.createModule<ExampleModule>();
+            if (!module) {
+                std::cout << "Creation refused during widget rounds" << std::endl;
+                return 1;
+            }
+            module->contentWidget();   // 相当于首次显示；复用的实例已经有内容控件
+            manager.destroyModule(module);
+        }
+        report(pooled ? "create+destroy ExampleModule (pooled)" : "create+destroy ExampleModule (no pool)",
+               timer.nsecsElapsed(), widgetRounds);
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+
+    // 延迟构建：创建只得到外壳，首次显示/contentWidget()时才构建内容控件
+    manager.setPoolCapacity(0);
+    std::vector<ExampleModule*> shells;
+    shells.reserve(widgetRounds);
+    qint64 rssBefore = residentKB();
+    timer.start();
+    for (int i = 0; i < widgetRounds; ++i) {
+        ExampleModule* module = manager.createModule<ExampleModule>();
+        if (!module) {
+            std::cout << "Creation refused during lazy rounds" << std::endl;
+            return 1;
+        }
+        shells.push_back(module);
+    }
+    const qint64 shellNs = timer.nsecsElapsed();
+    const qint64 shellKB = residentKB() - rssBefore;
+
+    rssBefore = residentKB();
+    timer.start();
+    for (ExampleModule* module : shells) {
+        module->contentWidget();
+    }
+    const qint64 contentNs = timer.nsecsElapsed();
+    const qint64 contentKB = residentKB() - rssBefore;
+
+    reportPerModule("create (lazy shell)", shellNs, shellKB, widgetRounds);
+    reportPerModule("build content on first show", contentNs, contentKB, widgetRounds);
+    reportPerModule("create (eager, shell + content)", shellNs + contentNs, shellKB + contentKB, widgetRounds);
+
+    manager.destroyAllModules();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    // 吸附/分离往返：内容在浮动窗口和白板宿主之间移动，不重建原生窗口；
+    // 对照组按旧方式把整个控件在顶层窗口和白板子控件之间重新设置父对象
+    const int attachRounds = qMin(count, 1000);
+    QWidget board;
+    board.resize(2000, 1200);
+    board.show();
+    const QRect slotRect(100, 100, 300, 400);
+
+    ExampleModule* attachModule = manager.createModule<ExampleModule>();
+    if (!attachModule) {
+        std::cout << "Creation refused during attach rounds" << std::endl;
+        return 1;
+    }
+    attachModule->show();
+    timer.start();
+    for (int i = 0; i < attachRounds; ++i) {
+        attachModule->embedInto(&board, slotRect);
+        attachModule->detachFromSlot();
+    }
+    report("attach/detach round-trip", timer.nsecsElapsed(), attachRounds);
+    manager.destroyModule(attachModule);
+
+    QWidget* reparented = new QWidget();
+    reparented->resize(slotRect.size());
+    reparented->show();
+    timer.start();
+    for (int i = 0; i < attachRounds; ++i) {
+        reparented->setParent(&board);
+        reparented->setGeometry(slotRect);
+        reparented->show();
+        reparented->setParent(nullptr, Qt::Window);
+        reparented->show();
+    }
+    report("attach/detach round-trip (reparent baseline)", timer.nsecsElapsed(), attachRounds);
+    delete reparented;
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    // 视口虚拟化：白板上只有可见的模块保留内容控件，其余停放（截图、休眠、隐藏宿主、释放框架的原生窗口）。
+    // 模块先作为浮动窗口显示再放入白板（与拖入白板的路径相同），隐藏的框架在停放之前持有原生窗口
+    const int boardModules = qMin(count, 1000);
+    const int visibleModules = qMin(boardModules, 24);
+    const int columns = 40;
+    QWidget virtualBoard;
+    virtualBoard.resize(columns * 310, (boardModules / columns + 1) * 410);
+    std::vector<ExampleModule*> boardMembers;
+    boardMembers.reserve(boardModules);
+    ModuleManager::releaseFreeHeap();
+    const qint64 boardBaselineKB = residentKB();
+    for (int i = 0; i < boardModules; ++i) {
+        ExampleModule* module = manager.createModule<ExampleModule>();
+        if (!module) {
+            std::cout << "Creation refused during virtualization rounds" << std::endl;
+            return 1;
+        }
+        module->show();
+        module->embedInto(&virtualBoard, QRect((i % columns) * 310, (i / columns) * 410, 300, 400));
+        boardMembers.push_back(module);
+    }
+    QCoreApplication::processEvents();
+    const qint64 liveRssKB = residentKB();
+
+    int parked = 0;
+    timer.start();
+    for (int i = visibleModules; i < boardModules; ++i) {
+        if (boardMembers[i]->park()) {
+            ++parked;
+        }
+    }
+    const qint64 parkNs = timer.nsecsElapsed();
+    // MainWindow在滚动停下后才释放空闲堆内存（scheduleHeapTrim()），这里直接释放，不计入停放耗时
+    ModuleManager::releaseFreeHeap();
+    const qint64 parkedRssKB = residentKB();
+    if (parked > 0) {
+        // 停放的模块仍占用的内存：停放后的RSS减去基线和可见模块（按平均的完整模块计算）
+        const double liveKBPerModule = double(liveRssKB - boardBaselineKB) / boardModules;
+        const double residualKB = parkedRssKB - boardBaselineKB - liveKBPerModule * (boardModules - parked);
+        std::cout << "park off-screen modules: " << parkNs / 1000.0 / parked << " us/module, "
+                  << double(liveRssKB - parkedRssKB) / parked << " KB RSS released/module, "
+                  << residualKB / parked << " KB RSS residual/parked module (live module: "
+                  << liveKBPerModule << " KB)" << std::endl;
+
+        timer.start();
+        for (int i = visibleModules; i < boardModules; ++i) {
+            boardMembers[i]->unpark();
+            boardMembers[i]->wake();
+        }
+        reportPerModule("unpark + rematerialize", timer.nsecsElapsed(), residentKB() - parkedRssKB, parked);
+    }
+
+    manager.destroyAllModules();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    return checkConsistency(manager, found, foundById, stale, count);
+}
@@ -1,9 +1,9 @@
-#include <QApplication>
 #include <QStyleFactory>
+#include "ModuleApplication.h"
 #include "MainWindow.h"
 
 int main(int argc, char *argv[]) {
-    QApplication app(argc, argv);
+    ModuleApplication app(argc, argv);
 
     // 设置应用程序信息
     app.setApplicationName("Module System");
@@ -11,9 +11,28 @@ CustomModuleTemplate::CustomModuleTemplate(QWidget *parent)
 {
     qDebug() << "[CustomModuleTemplate" << moduleId() << "] Created";
 
+    // 内容在首次显示时由基类调用buildContent()构建
+}
+
+CustomModuleTemplate::~CustomModuleTemplate() {
+    qDebug() << "[CustomModuleTemplate" << moduleId() << "] Destroyed";
+}
+
+void CustomModuleTemplate::clear() {
+    qDebug() << "[CustomModuleTemplate" << moduleId() << "] Clearing content";
+    ModuleBase::clear();   // 取消尚未完成的模型加载
+    // 在这里清理模块状态
+    // 例如：清除文本、重置按钮状态、释放资源等
+    // 销毁的模块会被回收到实例池并再次使用，这里需要恢复到刚创建时的状态
+    if (m_textEdit) {
+        m_textEdit->clear();
+    }
+}
+
+QWidget* CustomModuleTemplate::buildContent() {
     // 创建内容widget
-    m_contentWidget = new QWidget();
-    QVBoxLayout* layout = new QVBoxLayout(m_contentWidget);
+    QWidget* content = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(content);
 
     // 标题
     QLabel* titleLabel = new QLabel("Custom Module Template");
@@ -26,7 +45,7 @@ CustomModuleTemplate::CustomModuleTemplate(QWidget *parent)
                                    "Instructions:\n"
                                    "1. Copy this file and rename it\n"
                                    "2. Change the class name\n"
-                                   "3. Implement contentWidget() to define your UI\n"
+                                   "3. Implement buildContent() to define your UI\n"
                                    "4. Implement clear() to reset state\n"
                                    "5. Add creation method to ModuleManager\n"
                                    "6. Add menu item to MainWindow");
@@ -48,6 +67,7 @@ CustomModuleTemplate::CustomModuleTemplate(QWidget *parent)
 
     // 示例文本输入
     QTextEdit* exampleText = new QTextEdit();
+    m_textEdit = exampleText;
     exampleText->setPlaceholderText("This is where you can add custom UI elements...");
     exampleText->setMaximumHeight(80);
     exampleLayout->addWidget(exampleText);
@@ -55,29 +75,24 @@ CustomModuleTemplate::CustomModuleTemplate(QWidget *parent)
     layout->addWidget(exampleGroup);
 
     // 提示信息
-    QLabel* tipLabel = new QLabel("💡 Tip: Modify the contentWidget() method to create your custom UI!");
+    QLabel* tipLabel = new QLabel("💡 Tip: Modify the buildContent() method to create your custom UI!");
     tipLabel->setStyleSheet("color: #666; font-style: italic; margin-top: 10px;");
     layout->addWidget(tipLabel);
 
     layout->addStretch(); // 添加伸缩空间
-
-    // 设置布局
-    setLayout(layout);
+    return content;
 }
 
-CustomModuleTemplate::~CustomModuleTemplate() {
-    qDebug() << "[CustomModuleTemplate" << moduleId() << "] Destroyed";
+QVariantMap CustomModuleTemplate::saveState() const {
+    QVariantMap state;
+    if (m_textEdit) {
+        state.insert("text", m_textEdit->toPlainText());
+    }
+    return state;
 }
 
-void CustomModuleTemplate::clear() {
-    qDebug() << "[CustomModuleTemplate" << moduleId() << "] Clearing content";
-    // 在这里清理模块状态
-    // 例如：清除文本、重置按钮状态、释放资源等
-
-    // 示例：可以在这里重置UI状态
-    // 如果你添加了成员变量来跟踪状态，在这里清理它们
+void CustomModuleTemplate::restoreState(const QVariantMap& state) {
+    if (m_textEdit && state.contains("text")) {
+        m_textEdit->setPlainText(state.value("text").toString());
+    }
 }
-
-QWidget* CustomModuleTemplate::contentWidget() {
-    return m_contentWidget;
-}
\ No newline at end of file
@@ -11,9 +11,26 @@ ExampleModule::ExampleModule(QWidget *parent)
 {
     qDebug() << "[ExampleModule" << moduleId() << "] Created";
 
+    // 内容在首次显示时由基类调用buildContent()构建
+}
+
+ExampleModule::~ExampleModule() {
+    qDebug() << "[ExampleModule" << moduleId() << "] Destroyed";
+}
+
+void ExampleModule::clear() {
+    qDebug() << "[ExampleModule" << moduleId() << "] Clearing content";
+    ModuleBase::clear();   // 取消尚未完成的模型加载
+    // 模块会被回收复用，恢复到刚创建时的状态
+    if (m_textEdit) {
+        m_textEdit->clear();
+    }
+}
+
+QWidget* ExampleModule::buildContent() {
     // 创建内容widget
-    m_contentWidget = new QWidget();
-    QVBoxLayout* layout = new QVBoxLayout(m_contentWidget);
+    QWidget* content = new QWidget();
+    QVBoxLayout* layout = new QVBoxLayout(content);
 
     // 标题
     QLabel* titleLabel = new QLabel("Example Module");
@@ -22,7 +39,7 @@ ExampleModule::ExampleModule(QWidget *parent)
 
     // 描述
     QLabel* descLabel = new QLabel("This is an example module demonstrating the module system.\n"
-                                   "You can customize this module by modifying the contentWidget() method.");
+                                   "You can customize this module by modifying the buildContent() method.");
     descLabel->setWordWrap(true);
     descLabel->setStyleSheet("margin-bottom: 15px;");
     layout->addWidget(descLabel);
@@ -51,26 +68,25 @@ ExampleModule::ExampleModule(QWidget *parent)
     QVBoxLayout* textLayout = new QVBoxLayout(textGroup);
 
     QTextEdit* textEdit = new QTextEdit();
+    m_textEdit = textEdit;
     textEdit->setPlaceholderText("Enter some text here...");
     textEdit->setMaximumHeight(100);
     textLayout->addWidget(textEdit);
 
     layout->addWidget(textGroup);
-
-    // 设置布局
-    setLayout(layout);
+    return content;
 }
 
-ExampleModule::~ExampleModule() {
-    qDebug() << "[ExampleModule" << moduleId() << "] Destroyed";
+QVariantMap ExampleModule::saveState() const {
+    QVariantMap state;
+    if (m_textEdit) {
+        state.insert("text", m_textEdit->toPlainText());
+    }
+    return state;
 }
 
-void ExampleModule::clear() {
-    qDebug() << "[ExampleModule" << moduleId() << "] Clearing content";
-    // 在这里清理模块状态
-    // 例如：清除文本、重置按钮状态等
+void ExampleModule::restoreState(const QVariantMap& state) {
+    if (m_textEdit && state.contains("text")) {
+        m_textEdit->setPlainText(state.value("text").toString());
+    }
 }
-
-QWidget* ExampleModule::contentWidget() {
-    return m_contentWidget;
-}
\ No newline at end of file
@@ -8,6 +8,14 @@
 #include <QMoveEvent>
 #include <QCursor>
 #include <QEvent>
+#include <QElapsedTimer>
+#include <QMetaEnum>
+#include <QThreadPool>
+#include <QPromise>
+#include <QFutureWatcher>
+#include <QPixmapCache>
+#include <QWindow>
+#include "Trace.h"
 
 int ModuleBase::s_nextId = 1;
 
@@ -15,8 +23,20 @@ ModuleBase::ModuleBase(ModuleType type, const QString& title, QWidget *parent)
     : QWidget(parent)
     , m_type(type)
     , m_title(title)
-    , m_id(s_nextId++)
+    , m_id(allocateId())
+    , m_accounting(ModuleAccounting::registerModule(m_id, title))
     , m_isAttached(false)
+    , m_frameLayout(nullptr)
+    , m_body(nullptr)
+    , m_parked(false)
+    , m_rootLayout(nullptr)
+    , m_content(nullptr)
+    , m_placeholder(nullptr)
+    , m_hibernated(false)
+    , m_hibernatedByPark(false)
+    , m_modelLoaded(false)
+    , m_loadWatcher(nullptr)
+    , m_lastInteractionMs(interactionClockMs())
     , m_dragging(false)
     , m_titleBarDragging(false)
     , m_lastPos(-1, -1)
@@ -31,6 +51,15 @@ ModuleBase::ModuleBase(ModuleType type, const QString& title, QWidget *parent)
     // 不设置最小/最大限制，让attachToSlot时设置
     setAttribute(Qt::WA_DeleteOnClose, false);
 
+    // 内容控件/休眠占位控件都放在m_body中；m_body在浮动框架（模块自身）和白板宿主之间移动，
+    // 两者都只创建一次，附着/分离时不重建原生窗口
+    m_frameLayout = new QVBoxLayout(this);
+    m_frameLayout->setContentsMargins(0, 0, 0, 0);
+    m_body = new ModuleContainer(this, this);
+    m_frameLayout->addWidget(m_body);
+    m_rootLayout = new QVBoxLayout(m_body);
+    m_rootLayout->setContentsMargins(0, 0, 0, 0);
+
     // 安装事件过滤器以捕获关闭事件
     installEventFilter(this);
 
@@ -44,12 +73,26 @@ ModuleBase::ModuleBase(ModuleType type, const QString& title, QWidget *parent)
 }
 
 ModuleBase::~ModuleBase() {
+    // 加载任务只持有模型，通知它尽早结束即可
+    if (m_loadWatcher) {
+        m_model->cancel();
+    }
+    // 白板宿主属于白板，不随模块删除；内容先移回框架
+    if (m_boardHost) {
+        if (m_body->parentWidget() == m_boardHost) {
+            m_body->setParent(this);
+        }
+        delete m_boardHost;
+    }
+    QPixmapCache::remove(previewCacheKey());
+    ModuleAccounting::unregisterModule(m_id);
     qDebug() << "[Module" << m_id << "] Destroyed:" << m_title;
 }
 
 // 新方法：附着到白板（简化版 - 直接使用白板坐标）
 void ModuleBase::attachToSlot(const QRect& boardGlobalRect) {
-    m_isAttached = true;
+    MS_TRACE_SCOPE_ID("ModuleBase::attachToSlot", m_id);
+    setAttached(true);
     m_attachedSlotRect = boardGlobalRect;
 
     // 显示窗口
@@ -68,45 +111,385 @@ void ModuleBase::attachToSlot(const QRect& boardGlobalRect) {
     qDebug() << "[Module" << m_id << "] Attached to board at:" << boardGlobalRect;
 }
 
-// 新方法：附着到白板（切换到无边框模式）
+// 新方法：附着到白板（回到最近一次嵌入的白板位置）
 void ModuleBase::attachToBoard() {
-    m_isAttached = true;
+    MS_TRACE_SCOPE_ID("ModuleBase::attachToBoard", m_id);
+    if (!m_boardHost || !m_boardHost->parentWidget()) {
+        qWarning() << "[Module" << m_id << "] attachToBoard() without a previous board, use embedInto()";
+        return;
+    }
+    embedInto(m_boardHost->parentWidget(), m_boardHost->geometry());
+}
 
-    // 切换到无边框窗口（模拟嵌入模式）
-    Qt::WindowFlags flags = windowFlags();
-    flags |= Qt::FramelessWindowHint;  // 添加无边框标志
-    flags |= Qt::WindowStaysOnTopHint;
-    setWindowFlags(flags);
+// 嵌入白板：内容移入白板中的宿主控件，浮动框架只隐藏
+void ModuleBase::embedInto(QWidget* board, const QRect& localRect) {
+    MS_TRACE_SCOPE_ID("ModuleBase::embedInto", m_id);
+    setAttached(true);
+    m_attachedSlotRect = QRect();
 
-    // 显示窗口
-    show();
-    raise();
+    // 宿主只创建一次，之后在白板中隐藏/显示；它是普通子控件，没有原生窗口
+    if (!m_boardHost) {
+        m_boardHost = new ModuleContainer(this, board);
+        QVBoxLayout* hostLayout = new QVBoxLayout(m_boardHost);
+        hostLayout->setContentsMargins(0, 0, 0, 0);
+        m_boardHost->installEventFilter(this);
+    } else if (m_boardHost->parentWidget() != board) {
+        m_boardHost->setParent(board);
+    }
 
-    qDebug() << "[Module" << m_id << "] Attached to board (frameless mode)";
+    if (!m_hibernated) {
+        initializeContent();
+    }
+    m_boardHost->layout()->addWidget(m_body);
+    m_body->show();
+    m_boardHost->setGeometry(localRect);
+    m_boardHost->show();
+    m_boardHost->raise();
+    hide();
+
+    qDebug() << "[Module" << m_id << "] Embedded in board at:" << localRect;
 }
 
-// 新方法：从白板分离（切换到正常窗口模式）
-void ModuleBase::detachFromSlot() {
-    m_isAttached = false;
+// 离开白板：内容移回浮动框架，不显示框架
+void ModuleBase::leaveBoard() {
+    setAttached(false);
     m_attachedSlotRect = QRect();
+    m_parked = false;
+    if (!m_boardHost || m_body->parentWidget() != m_boardHost) {
+        return;
+    }
+    m_frameLayout->addWidget(m_body);
+    m_body->show();
+    m_boardHost->hide();
+}
 
-    // 恢复正常窗口模式（有标题栏）
-    Qt::WindowFlags flags = Qt::Window | Qt::WindowStaysOnTopHint;
-    setWindowFlags(flags);
-    setWindowTitle(m_title);
+bool ModuleBase::park() {
+    if (m_parked || !isEmbedded() || m_dragging || m_titleBarDragging) {
+        return false;
+    }
+    MS_TRACE_SCOPE_ID("ModuleBase::park", m_id);
+
+    // 先截图再休眠；截图只放在缓存中（占位控件不持有），总内存受缓存上限约束，
+    // 最近停放的模块（最可能先回到视口）的截图最后被淘汰
+    if (m_content && !m_hibernated) {
+        QPixmapCache::insert(previewCacheKey(), m_body->grab());
+        m_hibernatedByPark = hibernate();
+    } else if (m_hibernated && m_placeholder) {
+        m_placeholder->setText(hibernatedText());
+    }
+    m_boardHost->hide();
 
-    // 显示窗口
+    // 嵌入期间框架一直隐藏，但显示过的框架仍持有原生窗口和窗口表面；停放的模块在视口外，
+    // 不会被直接拖出白板，释放它们，detachFromSlot()中show()时再创建
+    QWindow* frameWindow = windowHandle();
+    if (frameWindow && frameWindow->handle()) {
+        frameWindow->destroy();
+    }
+    m_parked = true;
+
+    qDebug() << "[Module" << m_id << "] Parked";
+    return true;
+}
+
+void ModuleBase::unpark() {
+    if (!m_parked) {
+        return;
+    }
+    m_parked = false;
+
+    // 内容重建之前先显示停放时的截图
+    QPixmap preview;
+    if (m_hibernated && m_placeholder && QPixmapCache::find(previewCacheKey(), &preview)) {
+        m_placeholder->setPixmap(preview);
+    }
+    m_boardHost->show();
+
+    qDebug() << "[Module" << m_id << "] Unparked";
+}
+
+// 新方法：从白板分离（切换到正常窗口模式）
+void ModuleBase::detachFromSlot() {
+    MS_TRACE_SCOPE_ID("ModuleBase::detachFromSlot", m_id);
+    const bool embedded = isEmbedded();
+    const QRect hostRect = embedded ? QRect(m_boardHost->mapToGlobal(QPoint(0, 0)), m_boardHost->size())
+                                    : QRect();
+    leaveBoard();
+
+    // 浮动框架的原生窗口在嵌入期间保留（停放时释放，这里show()再创建），移动到内容原来的屏幕位置并重新显示
+    if (embedded) {
+        move(hostRect.topLeft());
+        resize(hostRect.size());
+    }
     show();
     raise();
 
+    // 从白板中拖出时，框架继续接收这次拖拽的鼠标事件
+    if (embedded && m_dragging) {
+        grabMouse();
+    }
+
     qDebug() << "[Module" << m_id << "] Detached from board (window mode)";
 }
 
+void ModuleBase::setAttached(bool attached) {
+    if (m_isAttached != attached) {
+        m_isAttached = attached;
+        emit attachedChanged(this, attached);
+    }
+}
+
+void ModuleBase::resetForPool() {
+    hide();
+    m_moveTimer->stop();
+    m_dragging = false;
+    m_titleBarDragging = false;
+    m_lastPos = QPoint(-1, -1);
+    m_lastMoveEventPos = QPoint(-1, -1);
+
+    if (m_isAttached) {
+        leaveBoard();
+    }
+    setMinimumSize(0, 0);
+    setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
+    resize(300, 400);
+
+    // 复用的实例是一个新模块：新的ID，资源统计从零开始
+    const int oldId = m_id;
+    QPixmapCache::remove(previewCacheKey());
+    ModuleAccounting::unregisterModule(m_id);
+    m_id = allocateId();
+    m_accounting = ModuleAccounting::registerModule(m_id, m_title);
+
+    qDebug() << "[Module" << oldId << "] Recycled as" << m_id;
+}
+
+void ModuleBase::adoptHeadlessModule(int id, const std::shared_ptr<ModuleModel>& model) {
+    const int oldId = m_id;
+    ModuleAccounting::unregisterModule(m_id);
+    m_id = id;
+    m_accounting = ModuleAccounting::registerModule(m_id, m_title);
+
+    // 模型已经在无界面创建时加载，构建内容控件时直接使用
+    if (model) {
+        m_model = model;
+        m_modelLoaded = true;
+    }
+
+    qDebug() << "[Module" << oldId << "] Attached as view of headless module" << m_id;
+}
+
+QString ModuleBase::moduleTypeName(ModuleType type) {
+    const char* key = QMetaEnum::fromType<ModuleType>().valueToKey(type);
+    if (key) {
+        return QString::fromLatin1(key);
+    }
+    if (type > UserDefined) {
+        return QString("UserDefined+%1").arg(int(type) - int(UserDefined));
+    }
+    return QString::number(int(type));
+}
+
 // 获取内容widget
 QWidget* ModuleBase::getContentWidget() {
     return contentWidget();
 }
 
+void ModuleBase::clear() {
+    cancelLoad();
+}
+
+QWidget* ModuleBase::contentWidget() {
+    if (m_hibernated) {
+        wake();
+    } else {
+        if (m_loadWatcher) {
+            m_loadWatcher->waitForFinished();
+            finishLoad();
+        }
+        initializeContent();
+    }
+    return m_content;
+}
+
+void ModuleBase::setVisible(bool visible) {
+    // 在显示之前构建，内容控件随窗口一起显示，不会先显示空窗口
+    if (visible && !m_hibernated) {
+        initializeContent();
+    }
+    QWidget::setVisible(visible);
+}
+
+qint64 ModuleBase::interactionClockMs() {
+    static QElapsedTimer clock;
+    if (!clock.isValid()) {
+        clock.start();
+    }
+    return clock.elapsed();
+}
+
+void ModuleBase::initializeContent() {
+    // 异步加载中显示占位控件，加载完成后再构建
+    if (m_content || m_loadWatcher) {
+        return;
+    }
+
+    // 构建可能发生在其它模块的事件中（首次显示/唤醒），构建期间的分配始终计入本模块
+    ModuleAccounting::Scope accounting(m_accounting);
+    if (!m_modelLoaded) {
+        // 同步创建的模块：模型在GUI线程中加载
+        MS_TRACE_SCOPE_ID("ModuleBase::loadModel", m_id);
+        m_model = createModel();
+        if (m_model) {
+            m_model->load();
+        }
+        m_modelLoaded = true;
+    }
+
+    MS_TRACE_SCOPE_ID("ModuleBase::buildContent", m_id);
+    m_content = buildContent();
+    if (m_content) {
+        m_rootLayout->addWidget(m_content);
+    }
+}
+
+bool ModuleBase::hibernate() {
+    MS_TRACE_SCOPE_ID("ModuleBase::hibernate", m_id);
+    if (m_hibernated || !m_content || m_dragging || m_titleBarDragging) {
+        return false;
+    }
+
+    m_savedState = saveState();
+
+    // 同步销毁整个内容控件树，内存立即归还
+    m_rootLayout->removeWidget(m_content);
+    delete m_content;
+    m_content = nullptr;
+
+    showPlaceholder(hibernatedText());
+
+    m_hibernated = true;
+    m_hibernatedByPark = false;
+    qDebug() << "[Module" << m_id << "] Hibernated";
+    emit hibernationChanged(this, true);
+    return true;
+}
+
+void ModuleBase::wake() {
+    if (!m_hibernated) {
+        return;
+    }
+    MS_TRACE_SCOPE_ID("ModuleBase::wake", m_id);
+    m_hibernated = false;
+    m_hibernatedByPark = false;
+
+    removePlaceholder();
+    initializeContent();
+    restoreState(m_savedState);
+    m_savedState.clear();
+    // 截图只代表停放时的内容
+    QPixmapCache::remove(previewCacheKey());
+
+    markInteraction();
+    qDebug() << "[Module" << m_id << "] Woke up";
+    emit hibernationChanged(this, false);
+}
+
+bool ModuleBase::beginLoad(QThreadPool* pool) {
+    if (m_modelLoaded || m_loadWatcher || m_content) {
+        return false;
+    }
+
+    m_model = createModel();
+    if (!m_model) {
+        m_modelLoaded = true;
+        return false;
+    }
+
+    // 任务只持有模型和promise，不访问模块；加载期间模块被销毁也是安全的
+    std::shared_ptr<ModuleModel> model = m_model;
+    std::shared_ptr<QPromise<void>> promise = std::make_shared<QPromise<void>>();
+    promise->start();
+
+    m_loadWatcher = new QFutureWatcher<void>(this);
+    connect(m_loadWatcher, &QFutureWatcher<void>::finished, this, &ModuleBase::finishLoad);
+    m_loadWatcher->setFuture(promise->future());
+
+    pool->start([model, promise]() {
+        MS_TRACE_SCOPE("ModuleModel::load");
+        if (!model->isCancelled()) {
+            model->load();
+        }
+        promise->finish();
+    });
+
+    showPlaceholder(QString("%1\n\n加载中…").arg(m_title));
+    qDebug() << "[Module" << m_id << "] Loading model in background";
+    return true;
+}
+
+void ModuleBase::finishLoad() {
+    if (!m_loadWatcher) {
+        return;
+    }
+    MS_TRACE_SCOPE_ID("ModuleBase::finishLoad", m_id);
+
+    // contentWidget()可能已经同步等待并完成，之后到达的finished信号不再处理
+    disconnect(m_loadWatcher, nullptr, this, nullptr);
+    m_loadWatcher->deleteLater();
+    m_loadWatcher = nullptr;
+    m_modelLoaded = true;
+
+    removePlaceholder();
+    initializeContent();
+
+    qDebug() << "[Module" << m_id << "] Model loaded";
+    emit loadFinished(this, true);
+}
+
+void ModuleBase::cancelLoad() {
+    if (!m_loadWatcher) {
+        return;
+    }
+
+    // 正在运行的load()看到取消标记后尽早返回；模块回到未加载的外壳状态
+    m_model->cancel();
+    disconnect(m_loadWatcher, nullptr, this, nullptr);
+    delete m_loadWatcher;
+    m_loadWatcher = nullptr;
+    m_model.reset();
+    m_modelLoaded = false;
+    removePlaceholder();
+
+    qDebug() << "[Module" << m_id << "] Load cancelled";
+    emit loadFinished(this, false);
+}
+
+void ModuleBase::showPlaceholder(const QString& text) {
+    if (!m_placeholder) {
+        m_placeholder = new QLabel(m_body);
+        m_placeholder->setAlignment(Qt::AlignCenter);
+        m_placeholder->setStyleSheet("color: #888; background-color: #f5f5f5;");
+        m_rootLayout->addWidget(m_placeholder);
+    }
+    m_placeholder->setText(text);
+}
+
+QString ModuleBase::hibernatedText() const {
+    return QString("%1\n\n已休眠，点击恢复").arg(m_title);
+}
+
+void ModuleBase::removePlaceholder() {
+    if (!m_placeholder) {
+        return;
+    }
+
+    // 占位控件可能正是当前鼠标事件的接收者，延迟删除
+    m_rootLayout->removeWidget(m_placeholder);
+    m_placeholder->hide();
+    m_placeholder->deleteLater();
+    m_placeholder = nullptr;
+}
+
 // 新方法：移动到全局位置
 void ModuleBase::moveToGlobalPos(const QPoint& globalPos) {
     move(globalPos);
@@ -114,6 +497,12 @@ void ModuleBase::moveToGlobalPos(const QPoint& globalPos) {
 
 // 事件处理：捕获标题栏拖动和关闭事件
 bool ModuleBase::event(QEvent *event) {
+    // 用户点击或激活休眠中的模块时透明重建
+    if (m_hibernated && (event->type() == QEvent::MouseButtonPress ||
+                         event->type() == QEvent::WindowActivate)) {
+        wake();
+    }
+
     if (event->type() == QEvent::Close) {
         qDebug() << "[Module" << m_id << "] Close event detected";
         // 发送关闭请求信号
@@ -146,6 +535,32 @@ bool ModuleBase::event(QEvent *event) {
     return QWidget::event(event);
 }
 
+bool ModuleBase::eventFilter(QObject *watched, QEvent *event) {
+    // 嵌入时鼠标事件从内容冒泡到白板宿主；在这里处理并截住，不传给白板（否则会拖动白板）
+    if (watched == m_boardHost) {
+        switch (event->type()) {
+            case QEvent::MouseButtonPress:
+                if (m_hibernated) {
+                    wake();
+                }
+                mousePressEvent(static_cast<QMouseEvent*>(event));
+                return true;
+            case QEvent::MouseMove:
+                mouseMoveEvent(static_cast<QMouseEvent*>(event));
+                return true;
+            case QEvent::MouseButtonRelease:
+                mouseReleaseEvent(static_cast<QMouseEvent*>(event));
+                return true;
+            case QEvent::MouseButtonDblClick:
+                mouseDoubleClickEvent(static_cast<QMouseEvent*>(event));
+                return true;
+            default:
+                break;
+        }
+    }
+    return QWidget::eventFilter(watched, event);
+}
+
 // 鼠标按下：开始内容区拖拽
 void ModuleBase::mousePressEvent(QMouseEvent *event) {
     if (event->button() == Qt::LeftButton) {
@@ -179,6 +594,7 @@ void ModuleBase::mouseMoveEvent(QMouseEvent *event) {
         move(newPos);
 
         // 发送位置信号用于槽位高亮
+        MS_TRACE_SCOPE_ID("ModuleBase::dragPositionChanged", m_id);
         emit dragPositionChanged(this, globalPos);
 
         event->accept();
@@ -192,11 +608,14 @@ void ModuleBase::mouseReleaseEvent(QMouseEvent *event) {
     if (event->button() == Qt::LeftButton && m_dragging) {
         qDebug() << "[Module" << m_id << "] Content drag released";
 
+        if (mouseGrabber() == this) {
+            releaseMouse();
+        }
+        m_dragging = false;
+
         // 发送reattach请求
         emit reattachRequested(this);
         emit dragPositionChanged(this, QPoint(-1, -1));
-
-        m_dragging = false;
     }
     QWidget::mouseReleaseEvent(event);
 }
@@ -227,6 +646,7 @@ void ModuleBase::moveEvent(QMoveEvent *event) {
         if (currentPos != m_lastMoveEventPos) {
             m_lastMoveEventPos = currentPos;
             QPoint mouseGlobalPos = QCursor::pos();
+            MS_TRACE_SCOPE_ID("ModuleBase::dragPositionChanged", m_id);
             emit dragPositionChanged(this, mouseGlobalPos);
 
             // 重启定时器
@@ -238,6 +658,7 @@ void ModuleBase::moveEvent(QMoveEvent *event) {
 
 // 移动停止定时器：检查智能放回
 void ModuleBase::onMoveTimeout() {
+    MS_TRACE_SCOPE_ID("ModuleBase::onMoveTimeout", m_id);
     // 只有在用户已经松手的情况下才尝试智能放回
     if (!m_dragging && !m_titleBarDragging && !m_isAttached) {
         QPoint mouseGlobalPos = QCursor::pos();
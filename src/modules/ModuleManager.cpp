@@ -1,148 +1,762 @@
 #include "modules/ModuleManager.h"
+#include "MetricsExporter.h"
+#include "Trace.h"
 #include <QDebug>
+#include <QPair>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QApplication>
+#include <algorithm>
+
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 ModuleManager::ModuleManager(QObject *parent)
     : QObject(parent)
+    , m_hibernatedCount(0)
+    , m_snapshotVersion(0)
+    , m_headless(qobject_cast<QApplication*>(QCoreApplication::instance()) == nullptr)
     , m_performanceMonitor(new PerformanceMonitor(this))
+    , m_metricsExporter(nullptr)
+    , m_hibernationEnabled(true)
+    , m_poolCapacity(DEFAULT_POOL_CAPACITY)
+    , m_memoryPressure(AdmissionController::Normal)
 {
-    qDebug() << "[ModuleManager] Initialized with performance monitoring";
+    // 内存严重不足时分批休眠模块，每批之间等待两次采样让指标反映释放效果
+    m_hibernationTimer = new QTimer(this);
+    m_hibernationTimer->setInterval(PerformanceMonitor::SAMPLE_INTERVAL_MS * 2);
+    connect(m_hibernationTimer, &QTimer::timeout, this, &ModuleManager::onHibernationTick);
+    connect(m_performanceMonitor, &PerformanceMonitor::performanceCritical,
+            this, &ModuleManager::onPerformanceCritical);
+    m_heapTrimTimer = new QTimer(this);
+    m_heapTrimTimer->setSingleShot(true);
+    m_heapTrimTimer->setInterval(HEAP_TRIM_DELAY_MS);
+    connect(m_heapTrimTimer, &QTimer::timeout, this, &ModuleManager::releaseFreeHeap);
+
+    // 实例池：启动后空闲时逐个预先构造，内存压力升高时缩小；无界面模式下不缓存（池中都是控件）
+    m_prewarmTimer = new QTimer(this);
+    m_prewarmTimer->setSingleShot(true);
+    connect(m_prewarmTimer, &QTimer::timeout, this, &ModuleManager::prewarmStep);
+    connect(m_performanceMonitor, &PerformanceMonitor::memoryPressureChanged,
+            this, &ModuleManager::onMemoryPressureChanged);
+    if (m_headless) {
+        m_poolCapacity = 0;
+    }
+    schedulePrewarm(PREWARM_STARTUP_DELAY_MS);
+
+    // 异步创建的模型加载；析构时等待仍在运行的加载任务（它们只访问模型）
+    m_loadPool = new QThreadPool(this);
+
+    // 插件只读取清单，库在创建第一个模块时才加载
+    m_pluginLoader.scanDefaultDirectories();
+
+    const QString metricsSocket = qEnvironmentVariable(MetricsExporter::SOCKET_ENV_VAR);
+    if (!metricsSocket.isEmpty()) {
+        startMetricsExporter(metricsSocket);
+    }
+
+    qDebug() << "[ModuleManager] Initialized with performance monitoring" << (m_headless ? "(headless)" : "");
 }
 
 ModuleManager::~ModuleManager() {
+    // 导出线程会读取性能监控器，先于它停止
+    delete m_metricsExporter;
+    m_metricsExporter = nullptr;
+
+    // 退出时不再回收，池中的实例直接删除
+    m_prewarmTimer->stop();
+    m_poolCapacity = 0;
     destroyAllModules();
+    trimPools();
     qDebug() << "[ModuleManager] Destroyed";
 }
 
-ExampleModule* ModuleManager::createExampleModule(QString* performanceReason) {
-    // 检查性能限制
-    if (!m_performanceMonitor->canCreateNewModule(performanceReason)) {
-        qWarning() << "[ModuleManager] Cannot create ExampleModule due to performance constraints";
+ModuleBase* ModuleManager::module(ModuleHandle handle) const {
+    const ModuleEntry* entry = m_modules.get(handle);
+    return entry ? entry->module : nullptr;
+}
+
+int ModuleManager::moduleId(ModuleHandle handle) const {
+    const ModuleEntry* entry = m_modules.get(handle);
+    return entry ? entry->id : -1;
+}
+
+ModuleModel* ModuleManager::model(ModuleHandle handle) const {
+    const ModuleEntry* entry = m_modules.get(handle);
+    if (!entry) {
         return nullptr;
     }
+    return entry->module ? entry->module->model() : entry->model.get();
+}
 
-    ExampleModule* module = new ExampleModule();
-    registerModule(module);
-    return module;
+ModuleHandle ModuleManager::handleById(int id) const {
+    return m_handlesById.value(id);
 }
 
-CustomModuleTemplate* ModuleManager::createCustomModule(QString* performanceReason) {
-    // 检查性能限制
-    if (!m_performanceMonitor->canCreateNewModule(performanceReason)) {
-        qWarning() << "[ModuleManager] Cannot create CustomModule due to performance constraints";
-        return nullptr;
+QList<ModuleHandle> ModuleManager::allModules() const {
+    QList<ModuleHandle> result;
+    result.reserve(m_modules.size());
+    for (int i = 0; i < m_modules.size(); ++i) {
+        result.append(m_modules.keyAt(i));
     }
+    return result;
+}
 
-    CustomModuleTemplate* module = new CustomModuleTemplate();
-    registerModule(module);
-    return module;
+QList<ModuleHandle> ModuleManager::modulesByType(ModuleBase::ModuleType type) const {
+    const int index = ModuleRegistry::indexOfType(type);
+    if (index != ModuleRegistry::UNREGISTERED_INDEX) {
+        return m_modulesByType[index];
+    }
+
+    // 未注册的类型共用一个桶，需要筛选
+    QList<ModuleHandle> result;
+    for (ModuleHandle handle : m_modulesByType[index]) {
+        if (m_modules.get(handle)->type == type) {
+            result.append(handle);
+        }
+    }
+    return result;
 }
 
-QList<ModuleBase*> ModuleManager::allModules() const {
-    return m_allModules;
+ModuleAccounting::Usage ModuleManager::moduleResourceUsage(int id) const {
+    return ModuleAccounting::usageOf(id);
 }
 
-QList<ModuleBase*> ModuleManager::modulesByType(ModuleBase::ModuleType type) const {
-    QList<ModuleBase*> result;
-    for (ModuleBase* module : m_allModules) {
-        if (module->moduleType() == type) {
-            result.append(module);
+QList<ModuleHandle> ModuleManager::modulesByResourceUsage() const {
+    // 先取出各模块的统计快照，排序时不再重复查询
+    QList<QPair<ModuleAccounting::Usage, ModuleHandle>> entries;
+    entries.reserve(m_modules.size());
+    forEachModule([&entries](ModuleBase* module) {
+        entries.append(qMakePair(module->resourceUsage(), module->moduleHandle()));
+    });
+
+    std::sort(entries.begin(), entries.end(),
+              [](const QPair<ModuleAccounting::Usage, ModuleHandle>& a,
+                 const QPair<ModuleAccounting::Usage, ModuleHandle>& b) {
+        if (a.first.allocatedBytes != b.first.allocatedBytes) {
+            return a.first.allocatedBytes > b.first.allocatedBytes;
         }
+        return a.first.cpuTimeUs > b.first.cpuTimeUs;
+    });
+
+    QList<ModuleHandle> result;
+    result.reserve(entries.size());
+    for (const auto& entry : entries) {
+        result.append(entry.second);
     }
     return result;
 }
 
-ModuleBase* ModuleManager::moduleById(int id) const {
-    for (ModuleBase* module : m_allModules) {
-        if (module->moduleId() == id) {
-            return module;
+bool ModuleManager::startMetricsExporter(const QString& socketName) {
+    if (!m_metricsExporter) {
+        m_metricsExporter = new MetricsExporter(m_performanceMonitor, this);
+
+        // 推送当前数量，之后随变化推送；抓取时不访问ModuleManager
+        ModuleRegistry::forEachType([this](auto tag) {
+            using Module = typename decltype(tag)::Type;
+            m_metricsExporter->setModuleCount(ModuleBase::moduleTypeName(Module::staticModuleType()),
+                                              moduleCount<Module>());
+        });
+        for (auto it = m_unregisteredCounts.constBegin(); it != m_unregisteredCounts.constEnd(); ++it) {
+            m_metricsExporter->setModuleCount(ModuleBase::moduleTypeName(it.key()), it.value());
         }
+        connect(this, &ModuleManager::moduleTypeCountChanged, m_metricsExporter,
+                [this](ModuleBase::ModuleType type, int count) {
+            m_metricsExporter->setModuleCount(ModuleBase::moduleTypeName(type), count);
+        });
+        publishHibernatedCount();
     }
-    return nullptr;
+    return m_metricsExporter->listen(socketName);
+}
+
+void ModuleManager::publishHibernatedCount() {
+    if (m_metricsExporter) {
+        m_metricsExporter->setHibernatedModuleCount(hibernatedModuleCount());
+    }
+}
+
+void ModuleManager::setHibernationEnabled(bool enabled) {
+    m_hibernationEnabled = enabled;
+    if (!enabled) {
+        m_hibernationTimer->stop();
+    }
+}
+
+void ModuleManager::scheduleHeapTrim() {
+    m_heapTrimTimer->start();
+}
+
+void ModuleManager::releaseFreeHeap() {
+#if defined(Q_OS_LINUX) && defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+int ModuleManager::hibernateLeastRecentlyUsed(int count) {
+    const qint64 now = ModuleBase::interactionClockMs();
+
+    QList<ModuleBase*> candidates;
+    forEachModule([&candidates, now](ModuleBase* module) {
+        if (module->isHibernated() || module->isActiveWindow()) {
+            return;
+        }
+        if (now - module->lastInteractionMs() < HIBERNATION_MIN_IDLE_MS) {
+            return;
+        }
+        candidates.append(module);
+    });
+
+    // 最久未交互的排在前面
+    std::sort(candidates.begin(), candidates.end(), [](ModuleBase* a, ModuleBase* b) {
+        return a->lastInteractionMs() < b->lastInteractionMs();
+    });
+
+    int hibernated = 0;
+    for (ModuleBase* module : candidates) {
+        if (hibernated >= count) {
+            break;
+        }
+        if (module->hibernate()) {
+            ++hibernated;
+        }
+    }
+
+    if (hibernated > 0) {
+        // 内容控件已同步销毁，稍后合并释放堆内存
+        scheduleHeapTrim();
+        qDebug() << "[ModuleManager] Hibernated" << hibernated << "modules,"
+                 << m_hibernatedCount << "of" << m_modules.size() << "now hibernated";
+    }
+    return hibernated;
+}
+
+int ModuleManager::hibernateBatch() {
+    const int awake = m_modules.size() - m_hibernatedCount;
+    return hibernateLeastRecentlyUsed(qMax(1, awake * HIBERNATION_BATCH_PERCENT / 100));
+}
+
+void ModuleManager::onPerformanceCritical(const QString& message) {
+    Q_UNUSED(message);
+    if (!m_hibernationEnabled || !m_performanceMonitor->isMemoryCritical()) {
+        return;
+    }
+
+    hibernateBatch();
+    m_hibernationTimer->start();
+}
+
+void ModuleManager::onHibernationTick() {
+    // 压力解除或已经没有可休眠的模块时停止
+    if (!m_performanceMonitor->isMemoryCritical() || hibernateBatch() == 0) {
+        m_hibernationTimer->stop();
+    }
+}
+
+void ModuleManager::onModuleHibernationChanged(ModuleBase* module, bool hibernated) {
+    m_hibernatedCount += hibernated ? 1 : -1;
+    publishHibernatedCount();
+    updateSnapshot(module->moduleHandle());
+    publishSnapshot();
+}
+
+void ModuleManager::onModuleAttachedChanged(ModuleBase* module, bool attached) {
+    Q_UNUSED(attached);
+    updateSnapshot(module->moduleHandle());
+    publishSnapshot();
+}
+
+void ModuleManager::destroyModule(ModuleHandle handle) {
+    destroyModules(QList<ModuleHandle>{handle});
 }
 
 void ModuleManager::destroyModule(ModuleBase* module) {
     if (!module) return;
+    destroyModules(QList<ModuleHandle>{module->moduleHandle()});
+}
 
-    qDebug() << "[ModuleManager] Destroying module:" << module->moduleId();
-    unregisterModule(module);
-    cleanupModule(module);
-    emit moduleDestroyed(module);
+void ModuleManager::destroyModules(const QList<ModuleHandle>& handles) {
+    MS_TRACE_SCOPE("ModuleManager::destroyModules");
+
+    QList<ModuleHandle> destroyed;
+    QList<ModuleBase::ModuleType> changedTypes;
+    bool hibernatedChanged = false;
+    int lastId = -1;
+    destroyed.reserve(handles.size());
+
+    for (ModuleHandle handle : handles) {
+        const ModuleEntry* entry = m_modules.get(handle);
+        if (!entry) {
+            continue;   // 已失效，或在同一批中重复出现
+        }
+
+        ModuleBase* module = entry->module;
+        const int typeIndex = entry->typeIndex;
+        const ModuleBase::ModuleType type = entry->type;
+        lastId = entry->id;
+
+        if (!changedTypes.contains(type)) {
+            changedTypes.append(type);
+        }
+        hibernatedChanged = hibernatedChanged || (module && module->isHibernated());
+
+        // 无界面模块只有模型，注销后随最后一个引用释放
+        removeModule(handle);
+        if (module && !recycleModule(module, typeIndex)) {
+            cleanupModule(module);
+        }
+        destroyed.append(handle);
+    }
+
+    if (destroyed.isEmpty()) {
+        return;
+    }
+
+    // 整批注销完成后统一发布、输出一行日志和通知
+    if (destroyed.size() == 1) {
+        qDebug() << "[ModuleManager] Destroyed module:" << lastId;
+    } else {
+        qDebug() << "[ModuleManager] Destroyed" << destroyed.size() << "modules";
+    }
+    publishSnapshot();
+    emit modulesDestroyed(destroyed);
+    for (ModuleBase::ModuleType type : changedTypes) {
+        emit moduleTypeCountChanged(type, moduleCountByType(type));
+    }
+    if (hibernatedChanged) {
+        publishHibernatedCount();
+    }
 }
 
 void ModuleManager::destroyAllModules() {
-    // 创建副本以避免在迭代时修改列表
-    QList<ModuleBase*> modulesToDestroy = m_allModules;
-    for (ModuleBase* module : modulesToDestroy) {
-        destroyModule(module);
+    // 从末尾开始注销，不需要移动其它元素
+    QList<ModuleHandle> handles;
+    handles.reserve(m_modules.size());
+    for (int i = m_modules.size() - 1; i >= 0; --i) {
+        handles.append(m_modules.keyAt(i));
     }
+    destroyModules(handles);
 }
 
 int ModuleManager::moduleCountByType(ModuleBase::ModuleType type) const {
-    return m_typeCounts.value(type, 0);
+    const int index = ModuleRegistry::indexOfType(type);
+    if (index != ModuleRegistry::UNREGISTERED_INDEX) {
+        return m_modulesByType[index].size();
+    }
+    return m_unregisteredCounts.value(type, 0);
 }
 
-bool ModuleManager::canCreateModule(ModuleBase::ModuleType type) const {
-    // 无限制版本 - 总是允许创建模块
-    Q_UNUSED(type);
-    return true;
+ModuleHandle ModuleManager::insertModule(ModuleBase* module, int typeIndex) {
+    MS_TRACE_SCOPE_ID("ModuleManager::insertModule", module->moduleId());
+
+    QList<ModuleHandle>& bucket = m_modulesByType[typeIndex];
+    const ModuleHandle handle = m_modules.insert(ModuleEntry{module, typeIndex, int(bucket.size()),
+                                                             module->moduleId(), module->moduleType(),
+                                                             nullptr, nullptr});
+    bucket.append(handle);
+    if (typeIndex == ModuleRegistry::UNREGISTERED_INDEX) {
+        ++m_unregisteredCounts[module->moduleType()];
+    }
+    m_handlesById.insert(module->moduleId(), handle);
+    module->m_handle = handle;
+    connectModule(module);
+    return handle;
 }
 
-void ModuleManager::registerModule(ModuleBase* module) {
-    if (!module) return;
+void ModuleManager::notifyModulesCreated(const QList<ModuleHandle>& handles) {
+    if (handles.isEmpty()) {
+        return;
+    }
 
-    m_allModules.append(module);
+    // 异步加载已经开始，快照中的状态包括“加载中”
+    QList<ModuleBase::ModuleType> changedTypes;
+    for (ModuleHandle handle : handles) {
+        updateSnapshot(handle);
+        const ModuleBase::ModuleType type = m_modules.get(handle)->type;
+        if (!changedTypes.contains(type)) {
+            changedTypes.append(type);
+        }
+    }
 
-    // 根据类型添加到特定列表
-    switch (module->moduleType()) {
-        case ModuleBase::Example:
-            m_exampleModules.append(static_cast<ExampleModule*>(module));
-            break;
-        case ModuleBase::Custom:
-            m_customModules.append(static_cast<CustomModuleTemplate*>(module));
-            break;
-        default:
-            // 对于其他类型，不添加到特定列表
-            break;
+    // 每批只输出一行日志
+    if (handles.size() == 1) {
+        const ModuleEntry* entry = m_modules.get(handles.first());
+        qDebug() << "[ModuleManager] Created module:" << entry->id
+                 << "Type:" << entry->type
+                 << "Title:" << (entry->module ? entry->module->moduleTitle() : QString());
+    } else {
+        qDebug() << "[ModuleManager] Created" << handles.size() << "modules";
     }
 
-    // 更新类型计数
-    m_typeCounts[module->moduleType()]++;
+    publishSnapshot();
+    emit modulesCreated(handles);
+    for (ModuleBase::ModuleType type : changedTypes) {
+        emit moduleTypeCountChanged(type, moduleCountByType(type));
+    }
+}
 
-    qDebug() << "[ModuleManager] Created module:" << module->moduleId()
-             << "Type:" << module->moduleType()
-             << "Title:" << module->moduleTitle();
+ModuleHandle ModuleManager::insertHeadlessModule(ModuleBase::ModuleType type, int typeIndex,
+                                                 const std::shared_ptr<ModuleModel>& model,
+                                                 ViewFactory viewFactory) {
+    const int id = ModuleBase::allocateId();
+    QList<ModuleHandle>& bucket = m_modulesByType[typeIndex];
+    const ModuleHandle handle = m_modules.insert(ModuleEntry{nullptr, typeIndex, int(bucket.size()),
+                                                             id, type, model, viewFactory});
+    bucket.append(handle);
+    if (typeIndex == ModuleRegistry::UNREGISTERED_INDEX) {
+        ++m_unregisteredCounts[type];
+    }
+    m_handlesById.insert(id, handle);
+    return handle;
+}
+
+void ModuleManager::removeModule(ModuleHandle handle) {
+    const ModuleEntry* entry = m_modules.get(handle);
+    if (!entry) {
+        return;
+    }
 
-    emit moduleCreated(module);
-    emit moduleTypeCountChanged(module->moduleType(), m_typeCounts[module->moduleType()]);
+    ModuleBase* module = entry->module;
+    const int id = entry->id;
+    const ModuleBase::ModuleType type = entry->type;
+    const int typeIndex = entry->typeIndex;
+    const int typePosition = entry->typePosition;
+
+    // 类型桶：用末尾的句柄填补空位，并更新它记录的位置
+    QList<ModuleHandle>& bucket = m_modulesByType[typeIndex];
+    const ModuleHandle lastOfType = bucket.takeLast();
+    if (lastOfType != handle) {
+        bucket[typePosition] = lastOfType;
+        m_modules.get(lastOfType)->typePosition = typePosition;
+    }
+    if (typeIndex == ModuleRegistry::UNREGISTERED_INDEX) {
+        --m_unregisteredCounts[type];
+    }
+
+    // 删除后句柄立即失效，deleteLater执行前也无法再解析到该模块
+    m_modules.remove(handle);
+    m_handlesById.remove(id);
+    updateSnapshot(handle);
+
+    if (module) {
+        module->m_handle = ModuleHandle();
+        disconnect(module, &ModuleBase::hibernationChanged, this, &ModuleManager::onModuleHibernationChanged);
+        disconnect(module, &ModuleBase::attachedChanged, this, &ModuleManager::onModuleAttachedChanged);
+        if (module->isHibernated()) {
+            --m_hibernatedCount;
+        }
+    }
 }
 
-void ModuleManager::unregisterModule(ModuleBase* module) {
-    if (!module) return;
+void ModuleManager::connectModule(ModuleBase* module) {
+    connect(module, &ModuleBase::hibernationChanged, this, &ModuleManager::onModuleHibernationChanged);
+    connect(module, &ModuleBase::attachedChanged, this, &ModuleManager::onModuleAttachedChanged);
+}
 
-    m_allModules.removeAll(module);
+void ModuleManager::updateSnapshot(ModuleHandle handle) {
+    const ModuleEntry* entry = m_modules.get(handle);
+    ModuleInfo info;
+    if (entry) {
+        info.handle = handle;
+        info.id = entry->id;
+        info.type = entry->type;
+        if (const ModuleBase* module = entry->module) {
+            info.title = module->moduleTitle();
+            info.flags = ModuleInfo::HasView;
+            info.flags |= module->isLoading() ? ModuleInfo::Loading : 0;
+            info.flags |= module->isHibernated() ? ModuleInfo::Hibernated : 0;
+            info.flags |= module->isAttached() ? ModuleInfo::Attached : 0;
+        }
+    }
+    m_snapshotEditor.set(handle.index, info);
+}
 
-    // 从类型特定列表中移除
-    switch (module->moduleType()) {
-        case ModuleBase::Example:
-            m_exampleModules.removeAll(static_cast<ExampleModule*>(module));
-            break;
-        case ModuleBase::Custom:
-            m_customModules.removeAll(static_cast<CustomModuleTemplate*>(module));
-            break;
-        default:
-            break;
+void ModuleManager::publishSnapshot() {
+    MS_TRACE_SCOPE("ModuleManager::publishSnapshot");
+    std::shared_ptr<ModuleSnapshot> snapshot = std::make_shared<ModuleSnapshot>();
+    snapshot->m_modules = m_snapshotEditor.snapshot();
+    snapshot->m_count = m_modules.size();
+    snapshot->m_version = ++m_snapshotVersion;
+    m_snapshot.publish(std::move(snapshot));
+}
+
+ModuleBase* ModuleManager::attachView(ModuleHandle handle) {
+    ModuleEntry* entry = m_modules.get(handle);
+    if (!entry) {
+        return nullptr;
+    }
+    if (entry->module) {
+        return entry->module;
+    }
+    if (m_headless || !entry->viewFactory) {
+        qWarning() << "[ModuleManager] Cannot attach a view to module" << entry->id << "without QApplication";
+        return nullptr;
     }
 
-    // 更新类型计数
-    if (m_typeCounts.contains(module->moduleType())) {
-        m_typeCounts[module->moduleType()]--;
-        emit moduleTypeCountChanged(module->moduleType(), m_typeCounts[module->moduleType()]);
+    MS_TRACE_SCOPE_ID("ModuleManager::attachView", entry->id);
+    ModuleBase* view = entry->viewFactory();
+    view->adoptHeadlessModule(entry->id, entry->model);
+    view->m_handle = handle;
+
+    // 构造视图不会修改槽位表，entry仍然有效
+    entry->module = view;
+    entry->model.reset();
+    connectModule(view);
+
+    updateSnapshot(handle);
+    publishSnapshot();
+    emit viewAttached(handle);
+    return view;
+}
+
+bool ModuleManager::checkWidgetsAvailable(QString* reason) const {
+    if (!m_headless) {
+        return true;
+    }
+    qWarning() << "[ModuleManager] Widgets are not available without QApplication";
+    if (reason) {
+        *reason = QString("没有QApplication，只能无界面创建模块（createHeadlessModules）");
+    }
+    return false;
+}
+
+void ModuleManager::loadModels(const QList<std::shared_ptr<ModuleModel>>& models) {
+    MS_TRACE_SCOPE("ModuleManager::loadModels");
+
+    // 每个模型一个任务，等待全部完成；任务只访问模型
+    QSemaphore done;
+    int started = 0;
+    for (const std::shared_ptr<ModuleModel>& model : models) {
+        if (!model) {
+            continue;
+        }
+        m_loadPool->start([model, &done]() {
+            MS_TRACE_SCOPE("ModuleModel::load");
+            model->load();
+            done.release();
+        });
+        ++started;
     }
+    done.acquire(started);
 }
 
 void ModuleManager::cleanupModule(ModuleBase* module) {
     if (module) {
+        MS_TRACE_SCOPE_ID("ModuleManager::cleanupModule", module->moduleId());
+        // 不依赖子类的clear()调用ModuleBase::clear()：先取消加载，等待中的future随之结束
+        module->cancelLoad();
         module->clear();
         module->deleteLater();
     }
-}
\ No newline at end of file
+}
+
+void ModuleManager::setPoolCapacity(int perType) {
+    // 无界面模式下不能构造控件
+    m_poolCapacity = m_headless ? 0 : qMax(0, perType);
+    trimPools();
+    schedulePrewarm(PREWARM_IDLE_DELAY_MS);
+}
+
+int ModuleManager::effectivePoolCapacity() const {
+    switch (m_memoryPressure) {
+        case AdmissionController::Critical:
+            return 0;
+        case AdmissionController::Warning:
+            return m_poolCapacity / 2;
+        default:
+            return m_poolCapacity;
+    }
+}
+
+int ModuleManager::pooledModuleCount() const {
+    int count = 0;
+    for (const QList<ModuleBase*>& pool : m_pools) {
+        count += pool.size();
+    }
+    return count;
+}
+
+bool ModuleManager::recycleModule(ModuleBase* module, int typeIndex) {
+    // 休眠中的模块已经没有内容控件，加载中的模块还没有，复用也要重建，直接删除
+    if (typeIndex == ModuleRegistry::UNREGISTERED_INDEX || module->isHibernated() || module->isLoading()) {
+        return false;
+    }
+
+    QList<ModuleBase*>& pool = m_pools[typeIndex];
+    if (pool.size() >= effectivePoolCapacity()) {
+        return false;
+    }
+
+    MS_TRACE_SCOPE_ID("ModuleManager::recycleModule", module->moduleId());
+    module->cancelLoad();
+    module->clear();
+    module->resetForPool();
+    pool.append(module);
+    return true;
+}
+
+void ModuleManager::trimPools() {
+    const int capacity = effectivePoolCapacity();
+    int released = 0;
+    for (QList<ModuleBase*>& pool : m_pools) {
+        while (pool.size() > capacity) {
+            // 池中的实例不是任何事件的接收者，可以同步删除
+            delete pool.takeLast();
+            ++released;
+        }
+    }
+
+    if (released > 0) {
+        qDebug() << "[ModuleManager] Released" << released << "pooled modules, capacity now" << capacity;
+    }
+}
+
+void ModuleManager::schedulePrewarm(int delayMs) {
+    if (!m_prewarmTimer->isActive() && prewarmTarget() > 0) {
+        m_prewarmTimer->start(delayMs);
+    }
+}
+
+void ModuleManager::onMemoryPressureChanged(AdmissionController::Level level) {
+    m_memoryPressure = level;
+    trimPools();
+    if (level == AdmissionController::Normal) {
+        schedulePrewarm(PREWARM_IDLE_DELAY_MS);
+    }
+}
+
+void ModuleManager::prewarmStep() {
+    // 界面卡顿时推迟，不和用户操作争抢事件循环
+    if (m_performanceMonitor->getUiLatency().janky) {
+        schedulePrewarm(PREWARM_STARTUP_DELAY_MS);
+        return;
+    }
+
+    // 每次只构造一个实例，之后回到事件循环
+    const int target = prewarmTarget();
+    bool built = false;
+    bool remaining = false;
+    ModuleRegistry::forEachType([this, target, &built, &remaining](auto tag) {
+        using Module = typename decltype(tag)::Type;
+        QList<ModuleBase*>& pool = m_pools[ModuleRegistry::indexOf<Module>()];
+        if (pool.size() >= target) {
+            return;
+        }
+        if (built) {
+            remaining = true;
+            return;
+        }
+
+        MS_TRACE_SCOPE("ModuleManager::prewarm");
+        pool.append(constructModule<Module>());
+        built = true;
+        remaining = pool.size() < target;
+    });
+
+    if (remaining) {
+        m_prewarmTimer->start(0);
+    }
+}
+
+void ModuleManager::prewarmPools() {
+    const int target = prewarmTarget();
+    ModuleRegistry::forEachType([this, target](auto tag) {
+        using Module = typename decltype(tag)::Type;
+        QList<ModuleBase*>& pool = m_pools[ModuleRegistry::indexOf<Module>()];
+        while (pool.size() < target) {
+            pool.append(constructModule<Module>());
+        }
+    });
+}
+
+void ModuleManager::startLoad(ModuleBase* module) {
+    if (!module->beginLoad(m_loadPool)) {
+        return;
+    }
+
+    std::shared_ptr<QPromise<ModuleHandle>> promise = std::make_shared<QPromise<ModuleHandle>>();
+    promise->start();
+    m_pendingLoads.insert(module, promise);
+    connect(module, &ModuleBase::loadFinished, this, &ModuleManager::onModuleLoadFinished);
+}
+
+QFuture<ModuleHandle> ModuleManager::loadFuture(ModuleBase* module) {
+    const std::shared_ptr<QPromise<ModuleHandle>> pending = module ? m_pendingLoads.value(module) : nullptr;
+    if (pending) {
+        return pending->future();
+    }
+
+    // 被拒绝（取消状态），或者不需要加载（立即完成）
+    QPromise<ModuleHandle> promise;
+    promise.start();
+    if (module) {
+        promise.addResult(module->moduleHandle());
+    } else {
+        promise.future().cancel();
+    }
+    promise.finish();
+    return promise.future();
+}
+
+void ModuleManager::onModuleLoadFinished(ModuleBase* module, bool succeeded) {
+    disconnect(module, &ModuleBase::loadFinished, this, &ModuleManager::onModuleLoadFinished);
+    const std::shared_ptr<QPromise<ModuleHandle>> promise = m_pendingLoads.take(module);
+    if (!promise) {
+        return;
+    }
+
+    // 取消发生在clear()中，此时模块可能已经注销
+    if (succeeded && m_modules.contains(module->moduleHandle())) {
+        updateSnapshot(module->moduleHandle());
+        publishSnapshot();
+        promise->addResult(module->moduleHandle());
+    } else {
+        promise->future().cancel();
+    }
+    promise->finish();
+}
+
+ModuleBase* ModuleManager::createPluginModule(ModuleBase::ModuleType type, QString* reason) {
+    return createPluginModuleImpl(type, reason, false);
+}
+
+QFuture<ModuleHandle> ModuleManager::createPluginModuleAsync(ModuleBase::ModuleType type, QString* reason) {
+    return loadFuture(createPluginModuleImpl(type, reason, true));
+}
+
+ModuleBase* ModuleManager::createPluginModuleImpl(ModuleBase::ModuleType type, QString* reason, bool loadAsync) {
+    if (!checkWidgetsAvailable(reason)) {
+        return nullptr;
+    }
+    if (!m_pluginLoader.hasType(type)) {
+        if (reason) {
+            *reason = QString("未知的插件模块类型: %1").arg(int(type));
+        }
+        return nullptr;
+    }
+
+    if (!m_performanceMonitor->canCreateNewModules(type, 1, reason)) {
+        qWarning() << "[ModuleManager] Cannot create" << m_pluginLoader.typeName(type)
+                   << "module due to performance constraints";
+        return nullptr;
+    }
+
+    // 首次创建时加载插件库；构造函数中的分配计入新模块
+    ModuleBase* module = nullptr;
+    {
+        ModuleAccounting::ConstructionScope accounting;
+        module = m_pluginLoader.createModule(type, reason);
+    }
+    if (!module) {
+        return nullptr;
+    }
+
+    // 插件类型不在编译期注册表中，使用未注册类型的存储桶，不进入实例池
+    const ModuleHandle handle = insertModule(module, ModuleRegistry::UNREGISTERED_INDEX);
+    if (loadAsync) {
+        startLoad(module);
+    }
+    m_performanceMonitor->recordModuleCreation(type);
+    notifyModulesCreated(QList<ModuleHandle>{handle});
+    return module;
+}
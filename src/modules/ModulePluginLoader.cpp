@@ -0,0 +1,162 @@
+#include "modules/ModulePluginLoader.h"
+#include "modules/ModulePluginInterface.h"
+#include "modules/ModuleRegistry.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPluginLoader>
+#include <QDebug>
+#include "Trace.h"
+
+const char* const ModulePluginLoader::PLUGIN_PATH_ENV_VAR = "MODULESYSTEM_PLUGIN_PATH";
+
+ModulePluginLoader::ModulePluginLoader() = default;
+
+ModulePluginLoader::~ModulePluginLoader() {
+    // 插件模块可能仍在deleteLater队列中，库不卸载（QPluginLoader析构时不会卸载）
+}
+
+int ModulePluginLoader::scanDefaultDirectories() {
+    int found = scanDirectory(QDir(QCoreApplication::applicationDirPath()).filePath("plugins"));
+
+    const QString paths = qEnvironmentVariable(PLUGIN_PATH_ENV_VAR);
+    for (const QString& path : paths.split(QDir::listSeparator(), Qt::SkipEmptyParts)) {
+        found += scanDirectory(path);
+    }
+    return found;
+}
+
+int ModulePluginLoader::scanDirectory(const QString& path) {
+    MS_TRACE_SCOPE("ModulePluginLoader::scanDirectory");
+    const QDir dir(path);
+    if (!dir.exists()) {
+        return 0;
+    }
+
+    int found = 0;
+    const QStringList manifests = dir.entryList(QStringList() << "*.json", QDir::Files, QDir::Name);
+    for (const QString& fileName : manifests) {
+        QFile file(dir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+        const QJsonObject manifest = document.object();
+        const QString library = manifest.value("library").toString();
+        if (parseError.error != QJsonParseError::NoError || library.isEmpty()) {
+            qWarning() << "[ModulePluginLoader] Invalid manifest:" << file.fileName() << parseError.errorString();
+            continue;
+        }
+
+        // 库文件名相对清单所在目录；QPluginLoader会补全平台的前缀和后缀
+        const QString libraryPath = QFileInfo(dir.filePath(library)).absoluteFilePath();
+        int pluginIndex = m_pluginIndex.value(libraryPath, -1);
+
+        for (const QJsonValue& value : manifest.value("modules").toArray()) {
+            const QJsonObject entry = value.toObject();
+            const ModuleBase::ModuleType type = ModuleBase::ModuleType(entry.value("type").toInt(-1));
+            const QString name = entry.value("name").toString();
+
+            if (type < ModuleBase::UserDefined || name.isEmpty()) {
+                qWarning() << "[ModulePluginLoader] Invalid module entry in" << file.fileName() << entry;
+                continue;
+            }
+            if (ModuleRegistry::indexOfType(type) != ModuleRegistry::UNREGISTERED_INDEX || hasType(type)) {
+                qWarning() << "[ModulePluginLoader] Duplicate module type" << int(type) << "in" << file.fileName();
+                continue;
+            }
+
+            if (pluginIndex < 0) {
+                pluginIndex = int(m_plugins.size());
+                m_plugins.push_back(Plugin{libraryPath, nullptr, nullptr, false});
+                m_pluginIndex.insert(libraryPath, pluginIndex);
+            }
+
+            const QString menuText = entry.value("menuText").toString(QString("Create %1 Module").arg(name));
+            m_typeIndex.insert(type, m_types.size());
+            m_typePlugin.insert(type, pluginIndex);
+            m_types.append(TypeInfo{type, name, menuText, libraryPath});
+            ++found;
+        }
+    }
+
+    if (found > 0) {
+        qDebug() << "[ModulePluginLoader] Found" << found << "plugin module types in" << dir.absolutePath();
+    }
+    return found;
+}
+
+QList<ModulePluginLoader::TypeInfo> ModulePluginLoader::types() const {
+    return m_types;
+}
+
+QString ModulePluginLoader::typeName(ModuleBase::ModuleType type) const {
+    const int index = m_typeIndex.value(type, -1);
+    return index >= 0 ? m_types.at(index).name : QString();
+}
+
+bool ModulePluginLoader::isLoaded(ModuleBase::ModuleType type) const {
+    const int pluginIndex = m_typePlugin.value(type, -1);
+    return pluginIndex >= 0 && m_plugins[pluginIndex].instance != nullptr;
+}
+
+ModulePluginInterface* ModulePluginLoader::load(Plugin& plugin, QString* error) {
+    if (plugin.instance || plugin.failed) {
+        if (!plugin.instance && error) {
+            *error = QString("插件加载失败: %1").arg(plugin.libraryPath);
+        }
+        return plugin.instance;
+    }
+
+    MS_TRACE_SCOPE("ModulePluginLoader::load");
+    plugin.loader.reset(new QPluginLoader(plugin.libraryPath));
+    QObject* root = plugin.loader->instance();
+    plugin.instance = qobject_cast<ModulePluginInterface*>(root);
+
+    if (!plugin.instance) {
+        plugin.failed = true;
+        const QString reason = root ? QString("没有实现ModulePluginInterface") : plugin.loader->errorString();
+        qWarning() << "[ModulePluginLoader] Failed to load" << plugin.libraryPath << reason;
+        if (error) {
+            *error = QString("插件加载失败: %1\n%2").arg(plugin.libraryPath, reason);
+        }
+        return nullptr;
+    }
+
+    qDebug() << "[ModulePluginLoader] Loaded plugin:" << plugin.loader->fileName();
+    return plugin.instance;
+}
+
+ModuleBase* ModulePluginLoader::createModule(ModuleBase::ModuleType type, QString* error) {
+    const int pluginIndex = m_typePlugin.value(type, -1);
+    if (pluginIndex < 0) {
+        if (error) {
+            *error = QString("未知的插件模块类型: %1").arg(int(type));
+        }
+        return nullptr;
+    }
+
+    ModulePluginInterface* instance = load(m_plugins[pluginIndex], error);
+    if (!instance) {
+        return nullptr;
+    }
+
+    ModuleBase* module = instance->createModule(type);
+    if (module && module->moduleType() != type) {
+        // 插件返回的模块与清单不一致，按类型的计数和菜单会出错
+        qWarning() << "[ModulePluginLoader] Plugin created type" << int(module->moduleType())
+                   << "for requested type" << int(type);
+        delete module;
+        module = nullptr;
+    }
+    if (!module && error) {
+        *error = QString("插件不提供模块类型 %1 (%2)").arg(typeName(type)).arg(int(type));
+    }
+    return module;
+}
@@ -0,0 +1,351 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "BoardVirtualizer.h"
+#include "PersistentArray.h"
+#include "RcuPointer.h"
+#include "SlotMap.h"
+#include "SpatialIndex.h"
+
+// 通用容器、几何索引和视口虚拟化簿记的测试（与平台无关，不需要QApplication）
+
+static int s_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cout << "FAILED: " << #cond << " (line " << __LINE__ << ")" << std::endl; \
+            ++s_failures; \
+        } \
+    } while (0)
+
+struct TestKey {
+    quint32 index = 0;
+    quint32 generation = 0;
+};
+
+static void testSlotMap() {
+    std::cout << "Testing SlotMap..." << std::endl;
+
+    SlotMap<TestKey, int> map;
+    CHECK(map.isEmpty());
+    CHECK(map.get(TestKey()) == nullptr);   // 空键
+
+    const TestKey a = map.insert(10);
+    const TestKey b = map.insert(20);
+    const TestKey c = map.insert(30);
+    CHECK(map.size() == 3);
+    CHECK(*map.get(a) == 10 && *map.get(b) == 20 && *map.get(c) == 30);
+
+    // 删除中间的值：末尾的值填补空位，其它键仍然有效
+    CHECK(map.remove(a));
+    CHECK(!map.remove(a));
+    CHECK(map.get(a) == nullptr);
+    CHECK(map.size() == 2);
+    CHECK(*map.get(b) == 20 && *map.get(c) == 30);
+    CHECK(map.values().at(0) == 30 && map.values().at(1) == 20);
+    CHECK(*map.get(map.keyAt(0)) == 30);
+
+    // 槽位复用后旧键仍然失效
+    const TestKey d = map.insert(40);
+    CHECK(d.index == a.index && d.generation != a.generation);
+    CHECK(map.get(a) == nullptr);
+    CHECK(*map.get(d) == 40);
+
+    // 越界的键
+    TestKey bogus;
+    bogus.index = 100;
+    bogus.generation = 1;
+    CHECK(!map.contains(bogus));
+
+    CHECK(map.remove(b) && map.remove(c) && map.remove(d));
+    CHECK(map.isEmpty());
+}
+
+static void testPersistentArray() {
+    std::cout << "Testing PersistentArray copy-on-write..." << std::endl;
+
+    PersistentArray<int>::Editor editor;
+    for (int i = 0; i < 2000; ++i) {
+        editor.set(quint32(i), i + 1);
+    }
+    const PersistentArray<int> first = editor.snapshot();
+    CHECK(first.at(0) == 1 && first.at(1999) == 2000);
+    CHECK(first.at(5000) == 0);          // 超出范围
+    CHECK(first.capacity() >= 2000);
+
+    // 之后的修改不影响已取得的版本
+    editor.set(5, -5);
+    editor.set(100000, 7);               // 树长高
+    const PersistentArray<int> second = editor.snapshot();
+    CHECK(first.at(5) == 6 && second.at(5) == -5);
+    CHECK(first.at(100000) == 0 && second.at(100000) == 7);
+    CHECK(second.at(1999) == 2000);
+    CHECK(second.at(50000) == 0);        // 未分配的子树
+
+    // 基于已有版本编辑
+    PersistentArray<int>::Editor branch(first);
+    branch.set(0, 42);
+    CHECK(branch.snapshot().at(0) == 42 && first.at(0) == 1 && second.at(0) == 1);
+
+    // 遍历按下标顺序，只访问已分配的叶子
+    int visited = 0;
+    int sum = 0;
+    bool ordered = true;
+    int previous = 0;
+    first.forEach([&](int value) {
+        ++visited;
+        sum += value;
+        if (value != 0) {
+            ordered = ordered && value > previous;
+            previous = value;
+        }
+    });
+    CHECK(visited == 2016);              // 63个叶子，每个32个值
+    CHECK(sum == 2000 * 2001 / 2);
+    CHECK(ordered);
+}
+
+static void testRcuPointer() {
+    std::cout << "Testing RcuPointer publishing..." << std::endl;
+
+    // 写入方保证所有字段相等；读取方持有的快照不应被修改或提前释放
+    struct Snapshot {
+        quint64 a;
+        quint64 b;
+        std::vector<quint64> values;
+    };
+
+    RcuPointer<Snapshot> pointer;
+    CHECK(pointer.load() && pointer.load()->a == 0);
+
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    std::atomic<quint64> lastSeen(0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            std::shared_ptr<const Snapshot> held;
+            while (!done.load()) {
+                std::shared_ptr<const Snapshot> s = pointer.load();
+                if (s->a != s->b || s->values.size() != 4 * (s->a % 8) ||
+                    (!s->values.empty() && s->values.back() != s->a)) {
+                    torn.fetch_add(1);
+                }
+                // 偶尔长时间持有一个快照，期间写入方继续发布
+                if (s->a % 1000 == 0) {
+                    held = s;
+                }
+                if (held && held->a != held->b) {
+                    torn.fetch_add(1);
+                }
+                lastSeen.store(s->a);
+            }
+        });
+    }
+
+    for (quint64 i = 1; i <= 50000; ++i) {
+        std::shared_ptr<Snapshot> s = std::make_shared<Snapshot>();
+        s->a = i;
+        s->b = i;
+        s->values.assign(4 * (i % 8), i);
+        pointer.publish(std::move(s));
+    }
+    done.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    CHECK(torn.load() == 0);
+    CHECK(lastSeen.load() > 0);
+    CHECK(pointer.load()->a == 50000);
+}
+
+static void testSpatialIndex() {
+    std::cout << "Testing SpatialIndex..." << std::endl;
+
+    SpatialIndex index(100);
+    CHECK(index.at(QPoint(0, 0)).isEmpty());
+    CHECK(!index.intersectsAny(QRect(0, 0, 1000, 1000)));
+    CHECK(index.nearest(QRect(0, 0, 10, 10), 1000) == -1);
+
+    // 1跨越多个格子，3在负坐标
+    index.insert(1, QRect(50, 50, 300, 200));     // x 50~349, y 50~249
+    index.insert(2, QRect(400, 50, 100, 100));    // x 400~499
+    index.insert(3, QRect(-150, -150, 100, 100)); // x,y -150~-51
+    CHECK(index.count() == 3);
+    CHECK(index.rect(2) == QRect(400, 50, 100, 100));
+
+    // 点查询
+    CHECK(index.at(QPoint(60, 60)) == QList<int>{1});
+    CHECK(index.at(QPoint(349, 249)) == QList<int>{1});
+    CHECK(index.at(QPoint(350, 60)).isEmpty());
+    CHECK(index.at(QPoint(-100, -100)) == QList<int>{3});
+    CHECK(index.at(QPoint(-50, -50)).isEmpty());
+
+    // 矩形查询：跨格子的元素只报告一次
+    QList<int> hits = index.intersecting(QRect(0, 0, 1000, 1000));
+    CHECK(hits.size() == 2);
+    CHECK((hits == QList<int>{1, 2} || hits == QList<int>{2, 1}));
+    CHECK(index.intersecting(QRect(-200, -200, 1000, 1000)).size() == 3);
+    CHECK(index.intersecting(QRect(350, 0, 50, 500)).isEmpty());   // 1和2之间的空隙
+    CHECK(index.intersectsAny(QRect(340, 240, 20, 20)));
+    CHECK(!index.intersectsAny(QRect(350, 150, 50, 50)));
+
+    // 间距与最近元素
+    CHECK(SpatialIndex::distance(QRect(0, 0, 10, 10), QRect(10, 0, 10, 10)) == 0);    // 相邻
+    CHECK(SpatialIndex::distance(QRect(0, 0, 10, 10), QRect(15, 20, 10, 10)) == 15);  // 横5 + 纵10
+    CHECK(index.nearest(QRect(360, 60, 30, 30), 20) == 1);    // 距1和2都为10，相同时取较小的键
+    CHECK(index.nearest(QRect(365, 60, 30, 30), 20) == 2);    // 距2为5，距1为15
+    CHECK(index.nearest(QRect(600, 600, 10, 10), 20) == -1);
+
+    // 更新：旧位置的格子不再包含该元素
+    index.insert(2, QRect(1000, 1000, 50, 50));
+    CHECK(index.count() == 3);
+    CHECK(index.at(QPoint(450, 100)).isEmpty());
+    CHECK(index.at(QPoint(1010, 1010)) == QList<int>{2});
+
+    CHECK(index.remove(1));
+    CHECK(!index.remove(1));
+    CHECK(!index.contains(1));
+    CHECK(index.at(QPoint(60, 60)).isEmpty());
+    CHECK(index.count() == 2);
+
+    // 大量互不重叠的矩形：查询只看附近的格子
+    SpatialIndex grid;
+    for (int i = 0; i < 10000; ++i) {
+        grid.insert(i, QRect((i % 100) * 40, (i / 100) * 40, 30, 30));
+    }
+    CHECK(grid.at(QPoint(40 * 57 + 5, 40 * 23 + 5)) == QList<int>{23 * 100 + 57});
+    CHECK(grid.intersecting(QRect(0, 0, 80, 80)).size() == 4);
+    CHECK(grid.nearest(QRect(40 * 10 + 32, 40 * 10, 6, 6), 8) == 10 * 100 + 10);
+
+    grid.clear();
+    CHECK(grid.count() == 0 && grid.at(QPoint(5, 5)).isEmpty());
+}
+
+static QList<int> sorted(QList<int> keys) {
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+static void testBoardVirtualizer() {
+    std::cout << "Testing BoardVirtualizer..." << std::endl;
+
+    // 20×20个300×400的卡槽，间隔10像素；键 = 行 * 20 + 列
+    SpatialIndex index;
+    for (int key = 0; key < 400; ++key) {
+        index.insert(key, QRect((key % 20) * 310, (key / 20) * 410, 300, 400));
+    }
+    // 与活动矩形相交的键（暴力计算，作为对照）
+    auto expectedLive = [&index](const QRect& liveRect) {
+        QList<int> keys;
+        for (int key = 0; key < 400; ++key) {
+            if (index.contains(key) && index.rect(key).intersects(liveRect)) {
+                keys.append(key);
+            }
+        }
+        return keys;
+    };
+    auto liveKeys = [](const BoardVirtualizer& virtualizer) {
+        return sorted(QList<int>(virtualizer.liveKeys().begin(), virtualizer.liveKeys().end()));
+    };
+
+    BoardVirtualizer virtualizer(300, 4);
+    CHECK(virtualizer.liveRect(QRect(0, 0, 620, 820)) == QRect(-300, -300, 1220, 1420));
+
+    // 第一帧：视口加边距覆盖3列3行，全部进入
+    const QRect viewport(0, 0, 620, 820);
+    BoardVirtualizer::Changes changes = virtualizer.update(index, viewport);
+    CHECK(changes.left.isEmpty());
+    CHECK(sorted(changes.entered) == (QList<int>{0, 1, 2, 20, 21, 22, 40, 41, 42}));
+    CHECK(liveKeys(virtualizer) == expectedLive(virtualizer.liveRect(viewport)));
+    CHECK(!virtualizer.isLive(3));   // 第4列从930开始，在边距之外
+
+    // 需要重建的键；1模拟内存压力下被休眠的模块（不是停放引起的），回到视口也不重建
+    QList<int> needsRebuild = changes.entered;
+    needsRebuild.removeAll(1);
+    for (int key : changes.entered) {
+        virtualizer.queueMaterialize(key);
+    }
+    auto needs = [&needsRebuild](int key) { return needsRebuild.contains(key); };
+
+    // 卡槽0被删除：之后不会再从队列中取出
+    index.remove(0);
+    virtualizer.remove(0);
+    CHECK(!virtualizer.isLive(0));
+    CHECK(virtualizer.pendingMaterializeCount() == 8);
+
+    QList<int> materialized;
+    auto takeFrame = [&]() {
+        const QList<int> batch = virtualizer.takeMaterializeBatch(needs);
+        CHECK(batch.size() <= virtualizer.materializePerFrame());
+        for (int key : batch) {
+            materialized.append(key);
+            needsRebuild.removeAll(key);   // 已唤醒
+        }
+        return batch.size();
+    };
+    CHECK(takeFrame() == 4);
+    CHECK(virtualizer.hasPendingMaterialize());
+
+    // 向右滚动11像素：第4列进入边距，没有键离开
+    const QRect scrolled(11, 0, 620, 820);
+    changes = virtualizer.update(index, scrolled);
+    CHECK(changes.left.isEmpty());
+    CHECK(sorted(changes.entered) == (QList<int>{3, 23, 43}));
+    CHECK(liveKeys(virtualizer) == expectedLive(virtualizer.liveRect(scrolled)));
+    for (int key : changes.entered) {
+        needsRebuild.append(key);
+        virtualizer.queueMaterialize(key);
+    }
+
+    // 预算分摊到之后的帧；跳过的键不占用预算
+    CHECK(takeFrame() == 4);
+    CHECK(takeFrame() == 2);
+    CHECK(!virtualizer.hasPendingMaterialize());
+    CHECK(takeFrame() == 0);
+    CHECK(sorted(materialized) == (QList<int>{2, 3, 20, 21, 22, 23, 40, 41, 42, 43}));
+
+    // 排队的键在重建之前离开视口：不再取出
+    virtualizer.queueMaterialize(2);
+    virtualizer.queueMaterialize(3);
+    needsRebuild.append(2);
+    needsRebuild.append(3);
+    const QList<int> before = liveKeys(virtualizer);
+    const QRect far(3100, 4100, 620, 820);
+    changes = virtualizer.update(index, far);
+    CHECK(sorted(changes.left) == before);
+    CHECK(changes.entered.size() == 16);   // 第9~12列、第9~12行
+    CHECK(liveKeys(virtualizer) == expectedLive(virtualizer.liveRect(far)));
+    CHECK(virtualizer.takeMaterializeBatch(needs).isEmpty());
+    CHECK(!virtualizer.hasPendingMaterialize());
+
+    // 视口不变时没有变化
+    changes = virtualizer.update(index, far);
+    CHECK(changes.left.isEmpty() && changes.entered.isEmpty());
+
+    virtualizer.clear();
+    CHECK(virtualizer.liveKeys().isEmpty() && !virtualizer.hasPendingMaterialize());
+}
+
+int main() {
+    std::cout << "Testing containers..." << std::endl;
+
+    testSlotMap();
+    testPersistentArray();
+    testRcuPointer();
+    testSpatialIndex();
+    testBoardVirtualizer();
+
+    if (s_failures > 0) {
+        std::cout << s_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All container tests passed" << std::endl;
+    return 0;
+}
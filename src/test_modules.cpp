@@ -1,12 +1,131 @@
 #include <iostream>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QWindow>
+#include <atomic>
 #include <memory>
+#include <thread>
 #include "modules/ModuleManager.h"
-#include "modules/ExampleModule.h"
-#include "modules/CustomModuleTemplate.h"
-#include "modules/CalculatorModule.h"
+#include "modules/ModuleRegistry.h"
+
+namespace {
+
+// 模型加载较慢的模块，用于测试异步创建
+class SlowModel : public ModuleModel {
+public:
+    void load() override {
+        for (int i = 0; i < 10 && !isCancelled(); ++i) {
+            QThread::msleep(10);
+        }
+        loaded = !isCancelled();
+    }
+    bool loaded = false;
+};
+
+class SlowModule : public ModuleBase {
+public:
+    SlowModule() : ModuleBase(staticModuleType(), "Slow") {}
+
+    static ModuleType staticModuleType() { return UserDefined; }
+    void clear() override { ModuleBase::clear(); }
+
+    static std::shared_ptr<ModuleModel> staticCreateModel() { return std::make_shared<SlowModel>(); }
+
+protected:
+    std::shared_ptr<ModuleModel> createModel() override { return staticCreateModel(); }
+    QWidget* buildContent() override {
+        return static_cast<SlowModel*>(model())->loaded ? new QWidget() : nullptr;
+    }
+};
+
+// 没有派生clear()调用链的模块：加载的取消只能由ModuleManager负责
+class NonChainingModule : public SlowModule {
+public:
+    void clear() override {}
+};
+
+// 超时返回false，future永远不结束时测试失败而不是挂起
+bool waitFor(const QFuture<ModuleHandle>& future, int timeoutMs = 10000) {
+    QElapsedTimer timer;
+    timer.start();
+    while (!future.isFinished()) {
+        if (timer.elapsed() > timeoutMs) {
+            return false;
+        }
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    return true;
+}
+
+// --headless：只有QCoreApplication，不能创建控件，只能无界面创建模块
+int runHeadless(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    std::cout << "Testing Module System without QApplication..." << std::endl;
+    bool ok = true;
+
+    ModuleManager manager;
+    if (!manager.isHeadless() || manager.poolCapacity() != 0) {
+        std::cout << "Manager not in headless mode under QCoreApplication" << std::endl;
+        ok = false;
+    }
+
+    // 需要控件的创建方式都被拒绝并说明原因
+    QString reason;
+    if (manager.createModule<ExampleModule>(&reason) || reason.isEmpty()) {
+        std::cout << "Widget module created without QApplication" << std::endl;
+        ok = false;
+    }
+    reason.clear();
+    if (!manager.createModules<ExampleModule>(3, &reason).isEmpty() || reason.isEmpty()) {
+        std::cout << "Widget modules batch-created without QApplication" << std::endl;
+        ok = false;
+    }
+    if (!manager.createModuleAsync<SlowModule>().isCanceled()) {
+        std::cout << "Async widget creation not refused without QApplication" << std::endl;
+        ok = false;
+    }
+    if (manager.totalModuleCount() != 0) {
+        std::cout << "Refused creations left modules registered" << std::endl;
+        ok = false;
+    }
+
+    // 无界面创建：模型已加载，没有视图，也不能附加视图
+    const QList<ModuleHandle> handles = manager.createHeadlessModules<SlowModule>(3);
+    if (handles.size() != 3 || manager.totalModuleCount() != 3) {
+        std::cout << "Headless batch creation failed" << std::endl;
+        ok = false;
+    }
+    for (ModuleHandle handle : handles) {
+        const SlowModel* model = static_cast<const SlowModel*>(manager.model(handle));
+        const ModuleInfo* info = manager.snapshot()->find(handle);
+        if (!manager.contains(handle) || manager.module(handle) || !model || !model->loaded ||
+            !info || info->testFlag(ModuleInfo::HasView) || manager.attachView(handle)) {
+            std::cout << "Headless module has a view or an unloaded model" << std::endl;
+            ok = false;
+        }
+    }
+
+    manager.destroyModules(handles);
+    if (manager.totalModuleCount() != 0 || manager.snapshot()->count() != 0) {
+        std::cout << "Headless modules not destroyed" << std::endl;
+        ok = false;
+    }
+    std::cout << "Headless mode " << (ok ? "passed" : "failed") << std::endl;
+
+    return ok ? 0 : 1;
+}
+
+} // namespace
 
 int main(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (QByteArray(argv[i]) == "--headless") {
+            return runHeadless(argc, argv);
+        }
+    }
+
     QApplication app(argc, argv);  // Qt需要QApplication
 
     std::cout << "Testing Module System..." << std::endl;
@@ -14,46 +133,193 @@ int main(int argc, char *argv[]) {
     // 创建模块管理器
     ModuleManager manager;
 
-    // 创建示例模块
-    ExampleModule* example = manager.createExampleModule();
-    if (example) {
-        std::cout << "Example module created successfully!" << std::endl;
-        std::cout << "Module ID: " << example->moduleId() << std::endl;
-        std::cout << "Module Title: " << example->moduleTitle().toStdString() << std::endl;
+    // 依次创建和销毁每个注册的模块类型
+    bool ok = true;
+    ModuleRegistry::forEachType([&manager, &ok](auto tag) {
+        using Module = typename decltype(tag)::Type;
+        const std::string typeName = ModuleBase::moduleTypeName(Module::staticModuleType()).toStdString();
+
+        QString reason;
+        Module* module = manager.createModule<Module>(&reason);
+        if (!module) {
+            std::cout << "Failed to create " << typeName << " module: " << reason.toStdString() << std::endl;
+            ok = false;
+            return;
+        }
+
+        std::cout << typeName << " module created successfully!" << std::endl;
+        std::cout << "Module ID: " << module->moduleId() << std::endl;
+        std::cout << "Module Title: " << module->moduleTitle().toStdString() << std::endl;
+
+        const ModuleHandle handle = module->moduleHandle();
+        if (manager.module(handle) != module || manager.moduleCount<Module>() != 1) {
+            std::cout << typeName << " module not found in registry" << std::endl;
+            ok = false;
+        }
 
         // 清理模块
-        manager.destroyModule(example);
-        std::cout << "Example module destroyed" << std::endl;
-    } else {
-        std::cout << "Failed to create example module" << std::endl;
+        manager.destroyModule(module);
+        if (manager.module(handle) || manager.moduleCount<Module>() != 0) {
+            std::cout << typeName << " module still registered after destroy" << std::endl;
+            ok = false;
+        }
+        std::cout << typeName << " module destroyed" << std::endl;
+
+        // 批量创建和销毁
+        const QList<Module*> batch = manager.createModules<Module>(3, &reason);
+        QList<ModuleHandle> batchHandles;
+        for (Module* created : batch) {
+            batchHandles.append(created->moduleHandle());
+        }
+        if (batch.size() != 3 || manager.moduleCount<Module>() != 3) {
+            std::cout << "Failed to batch create " << typeName << " modules: " << reason.toStdString() << std::endl;
+            ok = false;
+        }
+        manager.destroyModules(batchHandles);
+        if (manager.moduleCount<Module>() != 0) {
+            std::cout << typeName << " modules still registered after batch destroy" << std::endl;
+            ok = false;
+        }
+    });
+
+    // 异步创建：模型在线程池中加载，完成后构建内容控件
+    QFuture<ModuleHandle> future = manager.createModuleAsync<SlowModule>();
+    const QList<ModuleHandle> created = manager.allModules();
+    ModuleBase* slow = created.isEmpty() ? nullptr : manager.module(created.last());
+    if (!slow || !slow->isLoading()) {
+        std::cout << "Async module not loading" << std::endl;
+        ok = false;
+    }
+    waitFor(future);
+    if (future.isCanceled() || !manager.module(future.result()) ||
+        !manager.module(future.result())->isContentBuilt()) {
+        std::cout << "Async module not ready after load" << std::endl;
+        ok = false;
     }
+    manager.destroyModule(future.isCanceled() ? ModuleHandle() : future.result());
 
-    // 创建自定义模块
-    CustomModuleTemplate* custom = manager.createCustomModule();
-    if (custom) {
-        std::cout << "Custom module created successfully!" << std::endl;
-        std::cout << "Module ID: " << custom->moduleId() << std::endl;
-        std::cout << "Module Title: " << custom->moduleTitle().toStdString() << std::endl;
+    // 加载完成前销毁：clear()取消加载，future为取消状态
+    future = manager.createModuleAsync<SlowModule>();
+    manager.destroyAllModules();
+    waitFor(future);
+    if (!future.isCanceled()) {
+        std::cout << "Async load not cancelled by destroy" << std::endl;
+        ok = false;
+    }
 
-        // 清理模块
-        manager.destroyModule(custom);
-        std::cout << "Custom module destroyed" << std::endl;
-    } else {
-        std::cout << "Failed to create custom module" << std::endl;
+    // 子类的clear()没有调用ModuleBase::clear()时，销毁仍然取消加载
+    future = manager.createModuleAsync<NonChainingModule>();
+    manager.destroyAllModules();
+    if (!waitFor(future) || !future.isCanceled()) {
+        std::cout << "Async load not cancelled for a subclass that skips ModuleBase::clear()" << std::endl;
+        ok = false;
     }
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    std::cout << "Async creation " << (ok ? "passed" : "failed") << std::endl;
 
-    // 创建计算器模块
-    CalculatorModule* calculator = manager.createCalculatorModule();
-    if (calculator) {
-        std::cout << "Calculator module created successfully!" << std::endl;
-        std::cout << "Module ID: " << calculator->moduleId() << std::endl;
-        std::cout << "Module Title: " << calculator->moduleTitle().toStdString() << std::endl;
+    // 无界面创建：只有模型，需要时再附加视图
+    const ModuleHandle headless = manager.createHeadlessModule<SlowModule>();
+    SlowModel* headlessModel = static_cast<SlowModel*>(manager.model(headless));
+    if (!manager.contains(headless) || manager.module(headless) || !headlessModel || !headlessModel->loaded) {
+        std::cout << "Headless module not created with a loaded model" << std::endl;
+        ok = false;
+    }
+    ModuleBase* view = manager.attachView(headless);
+    if (!view || manager.module(headless) != view || view->moduleId() != manager.moduleId(headless) ||
+        !view->contentWidget()) {
+        std::cout << "Attached view does not match headless module" << std::endl;
+        ok = false;
+    }
+    manager.destroyModule(headless);
+    if (manager.contains(headless)) {
+        std::cout << "Headless module not destroyed" << std::endl;
+        ok = false;
+    }
+    std::cout << "Headless creation " << (ok ? "passed" : "failed") << std::endl;
 
-        // 清理模块
-        manager.destroyModule(calculator);
-        std::cout << "Calculator module destroyed" << std::endl;
-    } else {
-        std::cout << "Failed to create calculator module" << std::endl;
+    // 嵌入白板与停放：内容在浮动框架和白板宿主之间移动，停放时休眠并释放框架的原生窗口，
+    // 重新显示后可以唤醒，拖出白板时重新创建原生窗口
+    {
+        auto hasNativeWindow = [](QWidget* widget) {
+            return widget->windowHandle() && widget->windowHandle()->handle();
+        };
+        QWidget board;
+        board.resize(1000, 1000);
+        ExampleModule* embedded = manager.createModule<ExampleModule>();
+        if (embedded) {
+            embedded->show();
+            embedded->embedInto(&board, QRect(10, 10, 300, 400));
+        }
+        const bool embeddedOk = embedded && embedded->isEmbedded() && embedded->isAttached() &&
+                                embedded->isContentBuilt() && hasNativeWindow(embedded);
+        const bool parkedOk = embeddedOk && embedded->park() && embedded->isParked() &&
+                              embedded->isHibernated() && embedded->isHibernatedByPark() &&
+                              !embedded->isContentBuilt() && !hasNativeWindow(embedded);
+        if (parkedOk) {
+            embedded->unpark();
+            embedded->wake();
+        }
+        bool unparkedOk = parkedOk && !embedded->isParked() && embedded->isContentBuilt() &&
+                          !embedded->isHibernatedByPark();
+
+        // 停放之前已经休眠（例如内存压力下被ModuleManager休眠）：不算停放引起的，回到视口时不重建
+        if (unparkedOk && embedded->hibernate() && embedded->park()) {
+            unparkedOk = !embedded->isHibernatedByPark();
+            embedded->unpark();
+            embedded->wake();
+        } else {
+            unparkedOk = false;
+        }
+        if (unparkedOk) {
+            embedded->detachFromSlot();
+        }
+        if (!unparkedOk || embedded->isEmbedded() || embedded->isAttached() || embedded->park() ||
+            !embedded->isVisible() || !hasNativeWindow(embedded)) {
+            std::cout << "Board embedding or parking failed" << std::endl;
+            ok = false;
+        }
+        manager.destroyAllModules();
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+    std::cout << "Board embedding " << (ok ? "passed" : "failed") << std::endl;
+
+    // 快照：其它线程遍历时GUI线程继续创建和销毁，读到的每个快照都自洽
+    std::atomic<bool> stop(false);
+    std::atomic<int> inconsistent(0);
+    std::thread reader([&manager, &stop, &inconsistent]() {
+        while (!stop.load()) {
+            const std::shared_ptr<const ModuleSnapshot> snapshot = manager.snapshot();
+            int visited = 0;
+            snapshot->forEach([&](const ModuleInfo& info) {
+                ++visited;
+                if (snapshot->find(info.handle) != &info || !info.testFlag(ModuleInfo::HasView)) {
+                    inconsistent.fetch_add(1);
+                }
+            });
+            if (visited != snapshot->count()) {
+                inconsistent.fetch_add(1);
+            }
+        }
+    });
+    const quint64 versionBefore = manager.snapshot()->version();
+    for (int round = 0; round < 20; ++round) {
+        const QList<CustomModuleTemplate*> batch = manager.createModules<CustomModuleTemplate>(5);
+        if (!batch.isEmpty()) {
+            const ModuleInfo* info = manager.snapshot()->find(batch.first()->moduleHandle());
+            if (!info || info->id != batch.first()->moduleId() || info->title != batch.first()->moduleTitle()) {
+                inconsistent.fetch_add(1);
+            }
+        }
+        manager.destroyAllModules();
     }
-    return 0;  // 不运行app.exec()，直接退出
-}
\ No newline at end of file
+    stop.store(true);
+    reader.join();
+    if (inconsistent.load() != 0 || manager.snapshot()->count() != 0 ||
+        manager.snapshot()->version() <= versionBefore) {
+        std::cout << "Registry snapshot inconsistent" << std::endl;
+        ok = false;
+    }
+    std::cout << "Registry snapshot " << (ok ? "passed" : "failed") << std::endl;
+
+    return ok ? 0 : 1;  // 不运行app.exec()，直接退出
+}
@@ -0,0 +1,627 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <time.h>
+#include "AdmissionController.h"
+#include "LatencyHistogram.h"
+#include "MetricsExposition.h"
+#include "MetricsHistory.h"
+#include "ModuleAccounting.h"
+#include "ProcFs.h"
+#include "SeqLock.h"
+#include "Trace.h"
+
+// 无需QApplication的性能监控测试：用预先准备的/proc快照驱动采样器
+
+static int s_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cout << "FAILED: " << #cond << " (line " << __LINE__ << ")" << std::endl; \
+            ++s_failures; \
+        } \
+    } while (0)
+
+static void writeFile(const std::string& path, const std::string& content) {
+    // 截断写入，保持同一个inode，这样已打开的句柄能读到新内容
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    out << content;
+}
+
+static const char* kMeminfo =
+    "MemTotal:       16384000 kB\n"
+    "MemFree:         1024000 kB\n"
+    "MemAvailable:    4096000 kB\n"
+    "Buffers:          512000 kB\n"
+    "Cached:          2048000 kB\n";
+
+static const char* kMeminfoWithoutAvailable =
+    "MemTotal:        8192000 kB\n"
+    "MemFree:         1024000 kB\n"
+    "Buffers:          256000 kB\n"
+    "Cached:           768000 kB\n";
+
+static void testParsers() {
+    std::cout << "Testing /proc parsers..." << std::endl;
+
+    const char* stat = "cpu  100 20 30 800 50 0 0 0 0 0\ncpu0 50 10 15 400 25 0 0 0 0 0\n";
+    ProcFs::CpuTimes cpu;
+    CHECK(ProcFs::parseCpuTimes(stat, std::strlen(stat), &cpu));
+    CHECK(cpu.total == 1000);
+    CHECK(cpu.idle == 850);
+
+    const char* oldStat = "cpu 10 0 10 80\n";
+    CHECK(ProcFs::parseCpuTimes(oldStat, std::strlen(oldStat), &cpu));
+    CHECK(cpu.total == 100);
+    CHECK(cpu.idle == 80);
+
+    const char* badStat = "intr 1 2 3\n";
+    CHECK(!ProcFs::parseCpuTimes(badStat, std::strlen(badStat), &cpu));
+
+    ProcFs::MemInfo mem;
+    CHECK(ProcFs::parseMemInfo(kMeminfo, std::strlen(kMeminfo), &mem));
+    CHECK(mem.totalKB == 16384000);
+    CHECK(mem.availableKB == 4096000);
+
+    CHECK(ProcFs::parseMemInfo(kMeminfoWithoutAvailable, std::strlen(kMeminfoWithoutAvailable), &mem));
+    CHECK(mem.totalKB == 8192000);
+    CHECK(mem.availableKB == 2048000);
+
+    const char* statm = "123456 2560 300 10 0 5000 0\n";
+    quint64 resident = 0;
+    CHECK(ProcFs::parseStatmResident(statm, std::strlen(statm), &resident));
+    CHECK(resident == 2560);
+
+    // cgroup v1/v2混合格式中只取统一层级
+    const char* cgroup = "12:cpu,cpuacct:/legacy\n0::/app.slice/modules.service\n";
+    char path[256];
+    CHECK(ProcFs::parseCgroupPath(cgroup, std::strlen(cgroup), path, sizeof(path)));
+    CHECK(std::strcmp(path, "/app.slice/modules.service") == 0);
+
+    const char* v1Only = "4:memory:/user.slice\n";
+    CHECK(!ProcFs::parseCgroupPath(v1Only, std::strlen(v1Only), path, sizeof(path)));
+
+    quint64 value = 0;
+    bool unlimited = false;
+    CHECK(ProcFs::parseLimitValue("max\n", 4, &value, &unlimited));
+    CHECK(unlimited);
+    CHECK(ProcFs::parseLimitValue("536870912\n", 10, &value, &unlimited));
+    CHECK(!unlimited && value == 536870912);
+
+    quint64 quota = 0;
+    quint64 period = 0;
+    CHECK(ProcFs::parseCpuMax("max 100000\n", 11, &quota, &period, &unlimited));
+    CHECK(unlimited && period == 100000);
+    CHECK(ProcFs::parseCpuMax("50000 100000\n", 13, &quota, &period, &unlimited));
+    CHECK(!unlimited && quota == 50000 && period == 100000);
+
+    const char* cpuStat = "usage_usec_total 1\nusage_usec 123456\nuser_usec 100000\n";
+    CHECK(ProcFs::parseKeyedValue(cpuStat, std::strlen(cpuStat), "usage_usec", &value));
+    CHECK(value == 123456);
+    CHECK(!ProcFs::parseKeyedValue(cpuStat, std::strlen(cpuStat), "system_usec", &value));
+}
+
+static void testSampler() {
+    std::cout << "Testing ProcFs::Sampler with canned snapshots..." << std::endl;
+
+    char root[] = "/tmp/procfs_test_XXXXXX";
+    if (!mkdtemp(root)) {
+        std::cout << "FAILED: cannot create temporary directory" << std::endl;
+        ++s_failures;
+        return;
+    }
+    const std::string base(root);
+    mkdir((base + "/self").c_str(), 0700);
+
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    // 512MB的常驻内存
+    const quint64 residentPages = quint64(512) * 1024 * 1024 / quint64(pageSize);
+
+    writeFile(base + "/stat", "cpu  1000 0 1000 8000 0 0 0 0 0 0\n");
+    writeFile(base + "/meminfo", kMeminfo);
+    writeFile(base + "/self/statm", "999999 " + std::to_string(residentPages) + " 0 0 0 0 0\n");
+
+    ProcFs::Sampler sampler(root);
+    CHECK(sampler.isValid());
+
+    // 第一次采样没有基准，返回0
+    CHECK(sampler.cpuUsagePercent() == 0.0);
+
+    // 总计增加1000，其中idle增加250 => 75%
+    writeFile(base + "/stat", "cpu  1500 0 1250 8250 0 0 0 0 0 0\n");
+    const double usage = sampler.cpuUsagePercent();
+    CHECK(usage > 74.9 && usage < 75.1);
+
+    // 计数没有变化时不应该除以0
+    CHECK(sampler.cpuUsagePercent() == 0.0);
+
+    CHECK(sampler.systemMemoryTotalMB() == 16384000 / 1024);
+    CHECK(sampler.systemMemoryUsedMB() == (16384000 - 4096000) / 1024);
+    CHECK(sampler.processMemoryMB() == 512);
+
+    // 已打开的句柄应该能读到更新后的快照
+    writeFile(base + "/meminfo", kMeminfoWithoutAvailable);
+    CHECK(sampler.systemMemoryTotalMB() == 8192000 / 1024);
+    CHECK(sampler.systemMemoryUsedMB() == (8192000 - 2048000) / 1024);
+
+    // 清理
+    unlink((base + "/self/statm").c_str());
+    rmdir((base + "/self").c_str());
+    unlink((base + "/stat").c_str());
+    unlink((base + "/meminfo").c_str());
+    rmdir(root);
+
+    // 缺失的/proc根目录
+    ProcFs::Sampler missing("/nonexistent-proc-root");
+    CHECK(!missing.isValid());
+    CHECK(missing.cpuUsagePercent() == 0.0);
+    CHECK(missing.systemMemoryTotalMB() == 0);
+    CHECK(missing.processMemoryMB() == 0);
+}
+
+static void testCgroupSampler() {
+    std::cout << "Testing ProcFs::Sampler with cgroup v2 limits..." << std::endl;
+
+    char root[] = "/tmp/procfs_cgroup_test_XXXXXX";
+    if (!mkdtemp(root)) {
+        std::cout << "FAILED: cannot create temporary directory" << std::endl;
+        ++s_failures;
+        return;
+    }
+    const std::string base(root);
+    const std::string proc = base + "/proc";
+    const std::string cgroupRoot = base + "/cgroup";
+    const std::string slice = cgroupRoot + "/app.slice";
+    const std::string leaf = slice + "/modules.service";
+
+    mkdir(proc.c_str(), 0700);
+    mkdir((proc + "/self").c_str(), 0700);
+    mkdir(cgroupRoot.c_str(), 0700);
+    mkdir(slice.c_str(), 0700);
+    mkdir(leaf.c_str(), 0700);
+
+    // 主机: 16GB内存，CPU空闲
+    writeFile(proc + "/stat", "cpu  0 0 0 1000 0 0 0 0 0 0\n");
+    writeFile(proc + "/meminfo", kMeminfo);
+    writeFile(proc + "/self/statm", "0 0 0 0 0 0 0\n");
+    writeFile(proc + "/self/cgroup", "0::/app.slice/modules.service\n");
+
+    writeFile(cgroupRoot + "/cgroup.controllers", "cpu memory\n");
+    writeFile(slice + "/cgroup.controllers", "cpu memory\n");
+    writeFile(leaf + "/cgroup.controllers", "cpu memory\n");
+
+    // 叶子没有内存限制，上级限制为1GB；CPU限制为0.5核
+    writeFile(leaf + "/memory.max", "max\n");
+    writeFile(slice + "/memory.max", "1073741824\n");
+    writeFile(leaf + "/cpu.max", "50000 100000\n");
+    writeFile(slice + "/cpu.max", "max 100000\n");
+
+    // 900MB已用，其中100MB是可回收的inactive_file
+    writeFile(leaf + "/memory.current", "943718400\n");
+    writeFile(leaf + "/memory.stat", "anon 700000000\ninactive_file 104857600\n");
+    writeFile(leaf + "/cpu.stat", "usage_usec 1000000\nuser_usec 800000\n");
+
+    ProcFs::Sampler sampler(proc.c_str(), cgroupRoot.c_str());
+    CHECK(sampler.isValid());
+    CHECK(sampler.hasCgroup());
+
+    CHECK(sampler.systemMemoryTotalMB() == 1024);
+    CHECK(sampler.systemMemoryUsedMB() == 800);
+    CHECK(sampler.isMemoryLimited());
+
+    CHECK(sampler.cpuUsagePercentAt(10000000) == 0.0);
+    CHECK(sampler.isCpuLimited());
+    CHECK(sampler.cpuLimitCores() > 0.49 && sampler.cpuLimitCores() < 0.51);
+
+    // 1秒墙钟时间内用了0.4秒CPU，配额0.5核 => 80%（主机视角下几乎空闲）
+    writeFile(proc + "/stat", "cpu  10 0 0 1990 0 0 0 0 0 0\n");
+    writeFile(leaf + "/cpu.stat", "usage_usec 1400000\nuser_usec 1100000\n");
+    const double usage = sampler.cpuUsagePercentAt(11000000);
+    CHECK(usage > 79.9 && usage < 80.1);
+
+    // 取消限制后回到主机指标
+    writeFile(slice + "/memory.max", "max\n");
+    writeFile(leaf + "/cpu.max", "max 100000\n");
+    CHECK(sampler.systemMemoryTotalMB() == 16384000 / 1024);
+    CHECK(!sampler.isMemoryLimited());
+    writeFile(proc + "/stat", "cpu  10 0 0 2990 0 0 0 0 0 0\n");
+    CHECK(sampler.cpuUsagePercentAt(12000000) == 0.0);
+    CHECK(!sampler.isCpuLimited());
+
+    // 容器限制大于主机内存时仍以主机内存为准
+    writeFile(slice + "/memory.max", "107374182400\n");
+    CHECK(sampler.systemMemoryTotalMB() == 16384000 / 1024);
+
+    const std::string cleanup = "rm -rf '" + base + "'";
+    CHECK(std::system(cleanup.c_str()) == 0);
+}
+
+static void testSeqLock() {
+    std::cout << "Testing SeqLock snapshot publishing..." << std::endl;
+
+    // 写入方保证所有字段相等，读取方不应看到撕裂的快照
+    struct Snapshot {
+        double a;
+        quint64 b;
+        quint64 c;
+        bool flag;
+    };
+
+    SeqLock<Snapshot> lock;
+    CHECK(lock.load().b == 0);
+
+    std::atomic<bool> done(false);
+    std::atomic<int> torn(0);
+    std::thread reader([&]() {
+        while (!done.load()) {
+            Snapshot s = lock.load();
+            if (quint64(s.a) != s.b || s.b != s.c || s.flag != (s.b % 2 == 1)) {
+                torn.fetch_add(1);
+            }
+        }
+    });
+
+    for (quint64 i = 1; i <= 200000; ++i) {
+        lock.store(Snapshot{double(i), i, i, i % 2 == 1});
+    }
+    done.store(true);
+    reader.join();
+
+    CHECK(torn.load() == 0);
+    CHECK(lock.load().c == 200000);
+}
+
+static void testMetricsHistory() {
+    std::cout << "Testing MetricsHistory window statistics..." << std::endl;
+
+    MetricsHistory history;
+    CHECK(history.isEmpty());
+    CHECK(history.stats(MetricsHistory::CpuUsage, 10).count == 0);
+
+    // 1..20，其中最新的是20
+    for (int i = 1; i <= 20; ++i) {
+        history.append(MetricsHistory::Sample{double(i), double(i * 2), double(i * 100)});
+    }
+    CHECK(history.size() == 20);
+    CHECK(history.at(0).cpuUsagePercent == 20.0);
+    CHECK(history.at(19).cpuUsagePercent == 1.0);
+
+    // 最近10个: 11..20
+    MetricsHistory::WindowStats cpu = history.stats(MetricsHistory::CpuUsage, 10);
+    CHECK(cpu.count == 10);
+    CHECK(cpu.min == 11.0);
+    CHECK(cpu.max == 20.0);
+    CHECK(cpu.mean == 15.5);
+    CHECK(cpu.p95 == 20.0);
+
+    // 全部20个: P95为第19小的值
+    MetricsHistory::WindowStats memory = history.stats(MetricsHistory::MemoryUsage, 100);
+    CHECK(memory.count == 20);
+    CHECK(memory.p95 == 38.0);
+    CHECK(history.stats(MetricsHistory::ProcessMemory, 1).max == 2000.0);
+
+    // 单个尖峰不影响窗口平均
+    MetricsHistory spiky;
+    for (int i = 0; i < 4; ++i) {
+        spiky.append(MetricsHistory::Sample{20.0, 0.0, 0.0});
+    }
+    spiky.append(MetricsHistory::Sample{100.0, 0.0, 0.0});
+    CHECK(spiky.stats(MetricsHistory::CpuUsage, 5).mean == 36.0);
+    CHECK(spiky.stats(MetricsHistory::CpuUsage, 5).max == 100.0);
+
+    // 写满后覆盖最旧的样本
+    for (int i = 0; i < MetricsHistory::CAPACITY + 5; ++i) {
+        history.append(MetricsHistory::Sample{double(i), 0.0, 0.0});
+    }
+    CHECK(history.size() == MetricsHistory::CAPACITY);
+    CHECK(history.at(0).cpuUsagePercent == double(MetricsHistory::CAPACITY + 4));
+    CHECK(history.at(MetricsHistory::CAPACITY - 1).cpuUsagePercent == 5.0);
+}
+
+static void testLatencyHistogram() {
+    std::cout << "Testing LatencyHistogram percentiles..." << std::endl;
+
+    // 桶的上界必须单调递增，且每个值都落在上界不小于它的桶中
+    for (int i = 1; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        CHECK(LatencyHistogram::bucketUpperBound(i) > LatencyHistogram::bucketUpperBound(i - 1));
+    }
+    const quint64 probes[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 100, 16000, 50000, 1000000};
+    for (quint64 v : probes) {
+        const int bucket = LatencyHistogram::bucketFor(v);
+        CHECK(LatencyHistogram::bucketUpperBound(bucket) >= v);
+        CHECK(bucket == 0 || LatencyHistogram::bucketUpperBound(bucket - 1) < v);
+    }
+
+    LatencyHistogram histogram;
+    CHECK(histogram.percentileMicros(99.0) == 0);
+
+    // 98个16ms的帧加两个200ms的卡顿
+    for (int i = 0; i < 98; ++i) {
+        histogram.record(16000);
+    }
+    histogram.record(200000);
+    histogram.record(200000);
+
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.maxMicros() == 200000);
+
+    // 分桶误差不超过25%
+    const quint64 p50 = histogram.percentileMicros(50.0);
+    CHECK(p50 >= 16000 && p50 <= 20000);
+    const quint64 p99 = histogram.percentileMicros(99.0);
+    CHECK(p99 >= 200000 && p99 <= 250000);
+    CHECK(histogram.percentileMicros(100.0) == 200000);
+
+    histogram.reset();
+    CHECK(histogram.count() == 0);
+    CHECK(histogram.maxMicros() == 0);
+}
+
+static void testAdmissionController() {
+    std::cout << "Testing AdmissionController prediction and hysteresis..." << std::endl;
+
+    typedef AdmissionController AC;
+    const AC::Limits limits = AC::Limits{80.0, 85.0, 1024.0};
+    AC controller;
+
+    // 没有学习数据时等同于只看当前值
+    CHECK(controller.costOf(0).samples == 0);
+    CHECK(controller.predict(0, AC::Usage{10.0, 50.0, 8192.0, 900.0}, limits).allowed);
+    CHECK(!controller.predict(0, AC::Usage{90.0, 50.0, 8192.0, 900.0}, limits).allowed);
+
+    // 创建后未满稳定时间不结算
+    controller.recordCreation(0, AC::Usage{10.0, 50.0, 8192.0, 800.0}, 0);
+    controller.observe(AC::Usage{12.0, 50.0, 8192.0, 900.0}, 2000);
+    CHECK(controller.pendingCreations() == 1);
+    CHECK(controller.costOf(0).samples == 0);
+
+    controller.observe(AC::Usage{12.0, 50.0, 8192.0, 900.0}, AC::SETTLE_MS);
+    CHECK(controller.pendingCreations() == 0);
+    CHECK(controller.costOf(0).samples == 1);
+    CHECK(controller.costOf(0).rssMB == 100.0);
+    CHECK(controller.costOf(0).cpuPercent == 2.0);
+    // 未知类型使用全局平均
+    CHECK(controller.costOf(7).rssMB == 100.0);
+
+    // 当前值未超限，但加上预计开销会超过进程内存阈值
+    AC::Prediction prediction = controller.predict(0, AC::Usage{10.0, 50.0, 8192.0, 950.0}, limits);
+    CHECK(!prediction.allowed);
+    CHECK(prediction.resource == AC::ProcessMemory);
+    CHECK(prediction.predicted == 1050.0);
+    CHECK(controller.predict(0, AC::Usage{10.0, 50.0, 8192.0, 900.0}, limits).allowed);
+    // 批量创建按数量累计预计开销
+    prediction = controller.predict(0, AC::Usage{10.0, 50.0, 8192.0, 800.0}, limits, 3);
+    CHECK(!prediction.allowed);
+    CHECK(prediction.predicted == 1100.0);
+    CHECK(controller.predict(0, AC::Usage{10.0, 50.0, 8192.0, 800.0}, limits, 2).allowed);
+
+    // 同一时间段内的两次创建平分增量，负增量按0处理
+    controller.recordCreation(1, AC::Usage{20.0, 50.0, 8192.0, 900.0}, 10000);
+    controller.recordCreation(1, AC::Usage{20.0, 50.0, 8192.0, 900.0}, 10100);
+    controller.observe(AC::Usage{15.0, 50.0, 8192.0, 960.0}, 10000 + AC::SETTLE_MS + 100);
+    CHECK(controller.pendingCreations() == 0);
+    CHECK(controller.costOf(1).rssMB == 30.0);
+    CHECK(controller.costOf(1).cpuPercent == 0.0);
+
+    // 迟滞：进入和退出使用不同阈值，持续超限不重复报告
+    AC::Transition transitions[AC::RESOURCE_COUNT];
+    AC::Usage usage = AC::Usage{75.0, 10.0, 8192.0, 100.0};   // 75 > 80 * 0.9
+    CHECK(controller.updatePressure(usage, limits, transitions, AC::RESOURCE_COUNT) == 1);
+    CHECK(transitions[0].resource == AC::Cpu);
+    CHECK(transitions[0].to == AC::Warning);
+    CHECK(controller.updatePressure(usage, limits, transitions, AC::RESOURCE_COUNT) == 0);
+
+    usage.cpuPercent = 70.0;   // 低于进入阈值，但未低于退出阈值（80 * 0.8）
+    CHECK(controller.updatePressure(usage, limits, transitions, AC::RESOURCE_COUNT) == 0);
+    CHECK(controller.level(AC::Cpu) == AC::Warning);
+
+    usage.cpuPercent = 90.0;
+    CHECK(controller.updatePressure(usage, limits, transitions, AC::RESOURCE_COUNT) == 1);
+    CHECK(transitions[0].to == AC::Critical);
+    usage.cpuPercent = 78.0;   // 未低于严重退出阈值（80 * 0.95）时保持严重
+    CHECK(controller.updatePressure(usage, limits, transitions, AC::RESOURCE_COUNT) == 0);
+    usage.cpuPercent = 74.0;
+    CHECK(controller.updatePressure(usage, limits, transitions, AC::RESOURCE_COUNT) == 1);
+    CHECK(transitions[0].to == AC::Warning);
+    usage.cpuPercent = 60.0;
+    CHECK(controller.updatePressure(usage, limits, transitions, AC::RESOURCE_COUNT) == 1);
+    CHECK(transitions[0].to == AC::Normal);
+    CHECK(controller.level(AC::Cpu) == AC::Normal);
+}
+
+static void burnThreadCpu(long nanoseconds) {
+    timespec start;
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &start);
+    do {
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    } while ((now.tv_sec - start.tv_sec) * 1000000000L + (now.tv_nsec - start.tv_nsec) < nanoseconds);
+}
+
+static void testModuleAccounting() {
+    std::cout << "Testing ModuleAccounting attribution..." << std::endl;
+
+    ModuleAccounting::Counters* a = ModuleAccounting::registerModule(9001, "A");
+    ModuleAccounting::Counters* b = ModuleAccounting::registerModule(9002, "B");
+
+    // 不在任何模块中时不计入
+    delete[] new char[4096];
+    CHECK(ModuleAccounting::usageOf(9001).allocatedBytes == 0);
+
+    {
+        ModuleAccounting::Scope scopeA(a);
+        char* block = new char[1000];
+        delete[] block;
+        burnThreadCpu(20 * 1000 * 1000);
+
+        {
+            // 嵌套的其它模块：分配和CPU时间只计入最内层
+            ModuleAccounting::Scope scopeB(b);
+            delete[] new char[5000];
+            ModuleAccounting::Scope sameModule(b);
+            delete[] new char[5000];
+        }
+        delete[] new char[10];
+    }
+
+    const ModuleAccounting::Usage usageA = ModuleAccounting::usageOf(9001);
+    const ModuleAccounting::Usage usageB = ModuleAccounting::usageOf(9002);
+    CHECK(usageA.allocatedBytes == 1010);
+    CHECK(usageA.allocationCount == 2);
+    CHECK(usageA.eventCount == 1);
+    CHECK(usageA.cpuTimeUs >= 15000);
+    CHECK(usageB.allocatedBytes == 10000);
+    CHECK(usageB.eventCount == 1);
+    CHECK(usageB.cpuTimeUs < usageA.cpuTimeUs);
+
+    // 按累计分配量排序
+    QList<ModuleAccounting::ModuleUsage> top = ModuleAccounting::topModules(1);
+    CHECK(top.size() == 1);
+    CHECK(top.size() == 1 && top.at(0).moduleId == 9002);
+
+    // 构造期间注册的模块立即成为当前模块
+    {
+        ModuleAccounting::ConstructionScope construction;
+        delete[] new char[100];
+        ModuleAccounting::registerModule(9003, "C");
+        delete[] new char[300];
+    }
+    delete[] new char[300];
+    CHECK(ModuleAccounting::usageOf(9003).allocatedBytes == 300);
+
+    // 模块在自己的作用域内注销：计数器在作用域结束前保持有效
+    {
+        ModuleAccounting::Scope scopeA(a);
+        ModuleAccounting::unregisterModule(9001);
+        delete[] new char[10];
+    }
+    CHECK(ModuleAccounting::usageOf(9001).allocatedBytes == 0);
+
+    ModuleAccounting::unregisterModule(9002);
+    ModuleAccounting::unregisterModule(9003);
+    CHECK(ModuleAccounting::topModules(0).isEmpty());
+}
+
+static void testMetricsExposition() {
+    std::cout << "Testing MetricsExposition rendering..." << std::endl;
+
+    // 90个0.7ms的事件，10个90ms的事件
+    LatencyHistogram histogram;
+    for (int i = 0; i < 90; ++i) {
+        histogram.record(700);
+    }
+    for (int i = 0; i < 10; ++i) {
+        histogram.record(90000);
+    }
+
+    const MetricsExposition::Histogram exported = MetricsExposition::histogramFrom(histogram);
+    CHECK(exported.count == 100);
+    CHECK(exported.cumulative[0] == 90);                                           // le=0.001
+    CHECK(exported.cumulative[6] == 90);                                           // le=0.05
+    CHECK(exported.cumulative[7] == 100);                                          // le=0.1
+    CHECK(exported.cumulative[MetricsExposition::LATENCY_BOUND_COUNT - 1] == 100); // le=1
+    for (int i = 1; i < MetricsExposition::LATENCY_BOUND_COUNT; ++i) {
+        CHECK(exported.cumulative[i] >= exported.cumulative[i - 1]);
+    }
+
+    MetricsExposition::Snapshot snapshot = MetricsExposition::emptySnapshot();
+    snapshot.cpuUsagePercent = 12.5;
+    snapshot.processMemoryMB = 2;
+    snapshot.hasEventLoop = true;
+    snapshot.eventDuration = exported;
+    snapshot.stallCount = 3;
+    snapshot.moduleCounts.append(MetricsExposition::ModuleCount{"Example", 4});
+    snapshot.moduleCounts.append(MetricsExposition::ModuleCount{"Quote\"d", 1});
+
+    const QByteArray text = MetricsExposition::render(snapshot);
+    CHECK(text.contains("# TYPE modulesystem_cpu_usage_percent gauge\n"));
+    CHECK(text.contains("\nmodulesystem_cpu_usage_percent 12.5\n"));
+    CHECK(text.contains("\nmodulesystem_process_resident_bytes 2097152\n"));
+    CHECK(text.contains("\nmodulesystem_event_duration_seconds_bucket{le=\"0.1\"} 100\n"));
+    CHECK(text.contains("\nmodulesystem_event_duration_seconds_bucket{le=\"+Inf\"} 100\n"));
+    CHECK(text.contains("\nmodulesystem_event_duration_seconds_count 100\n"));
+    CHECK(text.contains("\nmodulesystem_event_loop_stalls_total 3\n"));
+    CHECK(text.contains("\nmodulesystem_modules{type=\"Example\"} 4\n"));
+    CHECK(text.contains("\nmodulesystem_modules{type=\"Quote\\\"d\"} 1\n"));
+
+    // 没有事件循环（无界面）时不输出延迟指标
+    snapshot.hasEventLoop = false;
+    CHECK(!MetricsExposition::render(snapshot).contains("modulesystem_event_duration_seconds"));
+}
+
+static void testTrace() {
+#ifdef MODULESYSTEM_TRACING
+    std::cout << "Testing Trace recording..." << std::endl;
+
+    Trace::clear();
+
+    {
+        MS_TRACE_SCOPE("Test::outer");
+        {
+            MS_TRACE_SCOPE_ID("Test::inner", 42);
+            burnThreadCpu(100 * 1000);
+        }
+        MS_TRACE_INSTANT_ID("Test::instant", 7);
+    }
+
+    // 其他线程写入自己的缓冲区
+    std::thread worker([]() {
+        MS_TRACE_SCOPE("Test::worker");
+    });
+    worker.join();
+
+    const QByteArray json = Trace::toJson();
+    CHECK(json.startsWith("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["));
+    CHECK(json.contains("\"name\":\"Test::outer\",\"ph\":\"X\""));
+    CHECK(json.contains("\"name\":\"Test::inner\",\"ph\":\"X\""));
+    CHECK(json.contains("\"args\":{\"id\":42}"));
+    CHECK(json.contains("\"name\":\"Test::instant\",\"ph\":\"i\""));
+    CHECK(json.contains("\"args\":{\"id\":7}"));
+    CHECK(json.contains("\"name\":\"Test::worker\",\"ph\":\"X\""));
+    CHECK(json.contains("\"name\":\"thread_name\""));
+
+    // 环形缓冲区写满后只保留最新的事件
+    Trace::clear();
+    for (int i = 0; i < Trace::EVENTS_PER_THREAD + 10; ++i) {
+        Trace::instant(i < 10 ? "Test::old" : "Test::new", i);
+    }
+    const QByteArray wrapped = Trace::toJson();
+    CHECK(!wrapped.contains("Test::old"));
+    CHECK(wrapped.contains("\"args\":{\"id\":10}"));
+
+    Trace::clear();
+    CHECK(!Trace::toJson().contains("\"ph\":\"X\""));
+    CHECK(!Trace::toJson().contains("\"ph\":\"i\""));
+#endif
+}
+
+int main() {
+    std::cout << "Testing PerformanceMonitor backends..." << std::endl;
+
+    testParsers();
+    testSampler();
+    testCgroupSampler();
+    testSeqLock();
+    testMetricsHistory();
+    testLatencyHistogram();
+    testAdmissionController();
+    testModuleAccounting();
+    testMetricsExposition();
+    testTrace();
+
+    if (s_failures > 0) {
+        std::cout << s_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All performance monitor tests passed" << std::endl;
+    return 0;
+}
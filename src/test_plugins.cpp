@@ -0,0 +1,152 @@
+#include <iostream>
+#include <QApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QTemporaryDir>
+#include "modules/ModuleManager.h"
+#include "modules/ModulePluginLoader.h"
+
+/**
+ * @brief 插件发现与延迟加载测试
+ *
+ * 在临时目录中写入清单（有效、无效JSON、缺少库、无效条目、重复类型），检查扫描结果；
+ * 然后通过MODULESYSTEM_PLUGIN_PATH让ModuleManager发现示例插件，确认库在第一次createPluginModule()时才加载。
+ * SAMPLE_PLUGIN_PATH由CMake定义为示例插件库的路径。使用offscreen平台，不需要显示器。
+ */
+
+namespace {
+
+const ModuleBase::ModuleType kSampleType = ModuleBase::ModuleType(ModuleBase::UserDefined + 1);
+const ModuleBase::ModuleType kMissingType = ModuleBase::ModuleType(ModuleBase::UserDefined + 2);
+
+bool writeManifest(const QTemporaryDir& dir, const QString& fileName, const QByteArray& content) {
+    QFile file(dir.filePath(fileName));
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) && file.write(content) == content.size();
+}
+
+// 进程是否已经映射了示例插件的库
+bool samplePluginMapped() {
+#ifdef Q_OS_LINUX
+    QFile maps("/proc/self/maps");
+    if (maps.open(QIODevice::ReadOnly)) {
+        return maps.readAll().contains(QFileInfo(SAMPLE_PLUGIN_PATH).fileName().toUtf8());
+    }
+#endif
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    // 清单放在临时目录中；必须在ModuleManager构造（扫描插件目录）之前设置环境变量
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        std::cout << "Cannot create temporary directory" << std::endl;
+        return 1;
+    }
+    qputenv(ModulePluginLoader::PLUGIN_PATH_ENV_VAR, dir.path().toLocal8Bit());
+
+    QApplication app(argc, argv);
+    QLoggingCategory::setFilterRules("default.debug=false");
+
+    std::cout << "Testing module plugins..." << std::endl;
+    bool ok = true;
+
+    // 按文件名顺序扫描：有效清单先于重复的清单
+    const QByteArray library = QByteArray(SAMPLE_PLUGIN_PATH);
+    ok = writeManifest(dir, "a_valid.json",
+             "{ \"library\": \"" + library + "\", \"modules\": ["
+             "  { \"type\": 1001, \"name\": \"Sample\", \"menuText\": \"Create Sample\" },"
+             "  { \"type\": 1002, \"name\": \"Missing\" } ] }") && ok;
+    ok = writeManifest(dir, "b_invalid_json.json", "{ \"library\": ") && ok;
+    ok = writeManifest(dir, "c_no_library.json",
+             "{ \"modules\": [ { \"type\": 1003, \"name\": \"NoLibrary\" } ] }") && ok;
+    ok = writeManifest(dir, "d_invalid_entries.json",
+             "{ \"library\": \"" + library + "\", \"modules\": ["
+             "  { \"type\": 5, \"name\": \"BelowUserDefined\" },"
+             "  { \"type\": 1004 } ] }") && ok;
+    ok = writeManifest(dir, "e_duplicates.json",
+             "{ \"library\": \"" + library + "\", \"modules\": ["
+             "  { \"type\": 1001, \"name\": \"DuplicatePlugin\" },"
+             "  { \"type\": 0, \"name\": \"DuplicateBuiltin\" } ] }") && ok;
+    if (!ok) {
+        std::cout << "Cannot write manifests" << std::endl;
+        return 1;
+    }
+
+    // 清单解析：只有有效清单中的两个类型被接受，不加载任何库
+    {
+        ModulePluginLoader loader;
+        const int found = loader.scanDirectory(dir.path());
+        const QList<ModulePluginLoader::TypeInfo> types = loader.types();
+        if (found != 2 || types.size() != 2 ||
+            types.at(0).type != kSampleType || types.at(0).name != "Sample" ||
+            types.at(0).menuText != "Create Sample" ||
+            types.at(1).type != kMissingType || types.at(1).menuText != "Create Missing Module") {
+            std::cout << "Unexpected manifest scan result: " << found << " types" << std::endl;
+            ok = false;
+        }
+        if (loader.hasType(ModuleBase::ModuleType(1003)) || loader.hasType(ModuleBase::ModuleType(1004)) ||
+            loader.typeName(kSampleType) != "Sample" || loader.isLoaded(kSampleType)) {
+            std::cout << "Invalid manifest entries accepted or library loaded during scan" << std::endl;
+            ok = false;
+        }
+
+        // 再次扫描同一目录：所有类型都是重复的
+        if (loader.scanDirectory(dir.path()) != 0 || loader.types().size() != 2) {
+            std::cout << "Rescan registered duplicate types" << std::endl;
+            ok = false;
+        }
+
+        QString error;
+        if (loader.createModule(ModuleBase::ModuleType(1003), &error) || error.isEmpty()) {
+            std::cout << "Unknown plugin type created" << std::endl;
+            ok = false;
+        }
+    }
+    std::cout << "Manifest scanning " << (ok ? "passed" : "failed") << std::endl;
+
+    // 环境变量中的目录被扫描；库在第一次创建该类型的模块时才加载
+    ModuleManager manager;
+    ModulePluginLoader* loader = manager.pluginLoader();
+    if (!loader->hasType(kSampleType) || !loader->hasType(kMissingType)) {
+        std::cout << "Plugin types from " << ModulePluginLoader::PLUGIN_PATH_ENV_VAR << " not found" << std::endl;
+        ok = false;
+    }
+    if (loader->isLoaded(kSampleType) || samplePluginMapped()) {
+        std::cout << "Plugin library loaded before first creation" << std::endl;
+        ok = false;
+    }
+
+    QString reason;
+    ModuleBase* module = manager.createPluginModule(kSampleType, &reason);
+    if (!module || module->moduleType() != kSampleType || !loader->isLoaded(kSampleType) ||
+        manager.moduleCountByType(kSampleType) != 1) {
+        std::cout << "Plugin module not created: " << reason.toStdString() << std::endl;
+        ok = false;
+    }
+#ifdef Q_OS_LINUX
+    if (!samplePluginMapped()) {
+        std::cout << "Plugin library not mapped after creation" << std::endl;
+        ok = false;
+    }
+#endif
+
+    // 清单中声明但插件不提供的类型：创建失败并说明原因
+    reason.clear();
+    if (manager.createPluginModule(kMissingType, &reason) || reason.isEmpty()) {
+        std::cout << "Type missing from the plugin was created" << std::endl;
+        ok = false;
+    }
+
+    manager.destroyAllModules();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    std::cout << "Lazy plugin loading " << (ok ? "passed" : "failed") << std::endl;
+
+    return ok ? 0 : 1;
+}